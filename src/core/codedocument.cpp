@@ -13,6 +13,8 @@
 #include "codedocument_p.h"
 #include "logger.h"
 #include "lsp_utils.h"
+#include "profiler.h"
+#include "progressoperation.h"
 #include "project.h"
 #include "querymatch.h"
 #include "rangemark.h"
@@ -241,6 +243,7 @@ std::pair<QString, std::optional<RangeMark>> CodeDocument::hoverWithRange(
                             asyncCallback(hoverText.first, hoverText.second);
                         });
     } else {
+        Profiler::Scope scope(Profiler::Lsp);
         auto result = client()->hover(std::move(params));
         if (result) {
             // We can't have this in "convertResult", as that would spam the log due to Hover being called when
@@ -268,6 +271,7 @@ RangeMarkList CodeDocument::references(int position) const
     params.textDocument.uri = toUri();
     params.position = Utils::lspFromPos(*this, position);
 
+    Profiler::Scope scope(Profiler::Lsp);
     if (auto result = client()->references(std::move(params))) {
         const auto &value = result.value();
         if (const auto *locations = std::get_if<std::vector<Lsp::Location>>(&value)) {
@@ -310,6 +314,7 @@ Document *CodeDocument::followSymbol(int pos)
     params.position.line = cursor.blockNumber();
     params.position.character = cursor.positionInBlock();
 
+    Profiler::Scope scope(Profiler::Lsp);
     auto result = client()->declaration(std::move(params));
 
     Q_ASSERT(result.has_value());
@@ -628,6 +633,17 @@ std::unique_ptr<TreeSitterHelper> &CodeDocument::helper()
     return m_treeSitterHelper;
 }
 
+// The operation lives as long as the cursor, so long queries show their progress and can be cancelled
+static void setQueryProgress(treesitter::QueryCursor &cursor, const std::shared_ptr<ProgressOperation> &operation)
+{
+    cursor.setProgressCallback([operation](uint32_t position, uint32_t size) {
+        if (operation->advance(position, size))
+            return true;
+        spdlog::warn("CodeDocument::query: cancelled by the user");
+        return false;
+    });
+}
+
 std::optional<treesitter::QueryCursor> CodeDocument::createQueryCursor(const std::shared_ptr<treesitter::Query> &query)
 {
     const auto &tree = m_treeSitterHelper->syntaxTree();
@@ -635,8 +651,9 @@ std::optional<treesitter::QueryCursor> CodeDocument::createQueryCursor(const std
         return {};
     }
 
+    Profiler::Scope scope(Profiler::TreeSitter);
     treesitter::QueryCursor cursor;
-    cursor.setProgressCallback(ScriptDialogItem::updateProgress);
+    setQueryProgress(cursor, std::make_shared<ProgressOperation>(QStringLiteral("Query"), QStringLiteral("matches")));
     cursor.execute(query, tree->rootNode(), std::make_unique<treesitter::Predicates>(text()));
     return cursor;
 }
@@ -648,6 +665,7 @@ Core::QueryMatch CodeDocument::queryFirst(const std::shared_ptr<treesitter::Quer
         return {};
     }
 
+    Profiler::Scope scope(Profiler::TreeSitter);
     auto match = cursor->nextMatch();
     if (match.has_value()) {
         return QueryMatch(*this, match.value());
@@ -663,11 +681,8 @@ Core::QueryMatchList CodeDocument::query(const std::shared_ptr<treesitter::Query
         return {};
     }
 
-    auto matches = cursor->allRemainingMatches();
-
-    return kdalgorithms::transformed<Core::QueryMatchList>(matches, [this](const treesitter::QueryMatch &match) {
-        return QueryMatch(*this, match);
-    });
+    Profiler::Scope scope(Profiler::TreeSitter);
+    return QueryMatch::fromMatches(*this, cursor->allRemainingMatches());
 }
 
 /*!
@@ -734,16 +749,52 @@ Core::QueryMatchList CodeDocument::queryInRange(const Core::RangeMark &range, co
     if (!tsQuery)
         return {};
 
+    Profiler::Scope scope(Profiler::TreeSitter);
     treesitter::QueryCursor cursor;
-    Core::QueryMatchList matches;
+    auto operation = std::make_shared<ProgressOperation>(QStringLiteral("Query"), QStringLiteral("matches"));
+    setQueryProgress(cursor, operation);
+    QList<treesitter::QueryMatch> matches;
     for (const treesitter::Node &node : nodes) {
         cursor.execute(tsQuery, node, std::make_unique<treesitter::Predicates>(text()));
-        matches.append(kdalgorithms::transformed<QList<QueryMatch>>(cursor.allRemainingMatches(),
-                                                                    [this](const treesitter::QueryMatch &match) {
-                                                                        return QueryMatch(*this, match);
-                                                                    }));
+        matches.append(cursor.allRemainingMatches());
+        if (operation->isCancelled())
+            break;
     }
-    return matches;
+    return QueryMatch::fromMatches(*this, matches);
+}
+
+/*!
+ * \qmlmethod QueryMatchIterator CodeDocument::queryIter(string query)
+ * Runs the given Tree-sitter `query` lazily, and returns an iterator on the matches.
+ *
+ * Contrary to `query`, matches are only searched when requested: this is a lot faster if you can stop the iteration
+ * before the end. The iterator can be used directly in a `for...of` loop, see
+ * [QueryMatchIterator](querymatchiterator.md) for more information.
+ *
+ * The iteration stops if the document is changed.
+ *
+ * \sa CodeDocument::query
+ */
+Core::QueryMatchIterator *CodeDocument::queryIter(const QString &query)
+{
+    LOG(LOG_ARG("query", query));
+
+    auto iterator = createQueryIterator(query);
+    // The iterator is only used by the script, see ScriptRunner::createEngine for the for...of support
+    QJSEngine::setObjectOwnership(iterator, QJSEngine::JavaScriptOwnership);
+    return iterator;
+}
+
+Core::QueryMatchIterator *CodeDocument::createQueryIterator(const QString &query)
+{
+    auto tsQuery = m_treeSitterHelper->constructQuery(query);
+    std::optional<treesitter::Tree> tree;
+    if (tsQuery) {
+        if (const auto &syntaxTree = m_treeSitterHelper->syntaxTree())
+            tree = syntaxTree->copy();
+    }
+
+    return new QueryMatchIterator(this, std::move(tree), tsQuery);
 }
 
 int CodeDocument::revision() const
@@ -785,6 +836,7 @@ void CodeDocument::changeContentLsp(int position, int charsRemoved, int charsAdd
         return;
     }
 
+    Profiler::Scope scope(Profiler::Lsp);
     if (client()->canSendDocumentChanges(Lsp::TextDocumentSyncKind::Full)
         || client()->canSendDocumentChanges(Lsp::TextDocumentSyncKind::Incremental)) {
         // TODO: We currently always send the entire document to the Language server, even
@@ -13,6 +13,7 @@
 #include "astnode.h"
 #include "lsp/client.h"
 #include "querymatch.h"
+#include "querymatchiterator.h"
 #include "symbol.h"
 #include "textdocument.h"
 #include "treesitter/parser.h"
@@ -54,6 +55,7 @@ public:
     Q_INVOKABLE Core::QueryMatchList query(const QString &query);
     Q_INVOKABLE Core::QueryMatch queryFirst(const QString &query);
     Q_INVOKABLE Core::QueryMatchList queryInRange(const Core::RangeMark &range, const QString &query);
+    Q_INVOKABLE Core::QueryMatchIterator *queryIter(const QString &query);
 
     // This overload exists for improved performance. It's not user-facing API.
     //
@@ -62,6 +64,8 @@ public:
     // So allow this for outside users.
     QList<Core::QueryMatch> query(const std::shared_ptr<treesitter::Query> &query);
     Core::QueryMatch queryFirst(const std::shared_ptr<treesitter::Query> &query);
+    // The iterator used by queryIter, the caller owns it.
+    Core::QueryMatchIterator *createQueryIterator(const QString &query);
 
     bool hasLspClient() const;
 
@@ -10,6 +10,7 @@
 
 #include "codedocument_p.h"
 #include "codedocument.h"
+#include "profiler.h"
 #include "treesitter/languages.h"
 #include "treesitter/tree_cursor.h"
 #include "utils/log.h"
@@ -48,6 +49,7 @@ treesitter::Parser &TreeSitterHelper::parser()
 std::optional<treesitter::Tree> &TreeSitterHelper::syntaxTree()
 {
     if (!m_tree) {
+        Profiler::Scope scope(Profiler::TreeSitter);
         auto &parser = this->parser();
         if (!parser.setIncludedRanges(m_document->includedRanges())) {
             spdlog::warn("{}: Unable to set the included ranges on the treesitter parser!", FUNCTION_NAME);
@@ -63,6 +65,7 @@ std::optional<treesitter::Tree> &TreeSitterHelper::syntaxTree()
 
 std::shared_ptr<treesitter::Query> TreeSitterHelper::constructQuery(const QString &query)
 {
+    Profiler::Scope scope(Profiler::TreeSitter);
     std::shared_ptr<treesitter::Query> tsQuery;
     try {
         tsQuery = std::make_shared<treesitter::Query>(parser().language(), query);
@@ -22,6 +22,7 @@
 #include <QHash>
 #include <QPlainTextEdit>
 #include <QRegularExpression>
+#include <QStringTokenizer>
 #include <QTextBlock>
 #include <QTextDocument>
 #include <QVariantMap>
@@ -149,7 +150,7 @@ static QString methodDeclarationQuery(const QString &declarator)
         .arg(declarator);
 }
 
-auto queryFunctionSymbols(CodeDocument *const document) -> QList<Core::Symbol *>
+static QString functionsQuery()
 {
     auto functionDeclarator = functionDeclaratorQuery("", std::nullopt);
     auto pointerDeclarator = pointerDeclaratorQuery(functionDeclarator, "@return");
@@ -158,7 +159,7 @@ auto queryFunctionSymbols(CodeDocument *const document) -> QList<Core::Symbol *>
     auto memberFunctionDeclaration = methodDeclarationQuery(pointerDeclarator);
 
     // clang-format off
-    auto functions = document->query(QString(R"EOF(
+    return QString(R"EOF(
         [; Free function implementations
         %3
 
@@ -177,21 +178,16 @@ auto queryFunctionSymbols(CodeDocument *const document) -> QList<Core::Symbol *>
 
         ; Member functions
         %4
-    ])EOF").arg(functionDeclarator, pointerDeclarator, functionDefinition, memberFunctionDeclaration));
+    ])EOF").arg(functionDeclarator, pointerDeclarator, functionDefinition, memberFunctionDeclaration);
     // clang-format on
+}
+
+auto queryFunctionSymbols(CodeDocument *const document) -> QList<Core::Symbol *>
+{
+    auto functions = document->query(functionsQuery());
 
     auto function_to_symbol = [document](const QueryMatch &match) {
-        auto kind = Symbol::Kind::Function;
-        if (!match.get("return").isValid()) {
-            // No return type, this is a Constructor/Destructor
-            // Clangd also assigned the Constructor kind to Destructors, so we'll do the same
-            kind = Symbol::Kind::Constructor;
-        } else if (match.get("name").text().contains("::")) {
-            // This is a bit of a guesstimate, but if the function name contains "::", it's likely a method.
-            // It may also be a member of a namespace, but this information isn't really available unless we try
-            // to resolve the original declaration.
-            kind = Symbol::Kind::Method;
-        }
+        const auto kind = cppFunctionKind(match.get("return").isValid(), match.get("name").text());
         return Symbol::makeSymbol(document, match, kind);
     };
 
@@ -241,22 +237,26 @@ auto queryMemberSymbols(CodeDocument *const document) -> QList<Core::Symbol *>
 
     return kdalgorithms::transformed<QList<Symbol *>>(members, member_to_symbol);
 }
-auto queryEnumSymbols(CodeDocument *const document) -> QList<Core::Symbol *>
-{
-    auto enums = document->query(R"EOF(
+constexpr char enumQuery[] = R"EOF(
         (enum_specifier
           name: (_) @name @selectionRange) @range
-    )EOF");
+    )EOF";
+
+constexpr char enumeratorQuery[] = R"EOF(
+        (enumerator
+          name: (_) @name @selectionRange
+          value: (_)? @value) @range
+    )EOF";
+
+auto queryEnumSymbols(CodeDocument *const document) -> QList<Core::Symbol *>
+{
+    auto enums = document->query(enumQuery);
     auto enum_to_symbol = [document](const QueryMatch &match) {
         return Symbol::makeSymbol(document, match, Symbol::Kind::Enum);
     };
     auto result = kdalgorithms::transformed<QList<Symbol *>>(enums, enum_to_symbol);
 
-    auto enumerators = document->query(R"EOF(
-        (enumerator
-          name: (_) @name @selectionRange
-          value: (_)? @value) @range
-    )EOF");
+    auto enumerators = document->query(enumeratorQuery);
     result.append(kdalgorithms::transformed<QList<Symbol *>>(enumerators, enum_to_symbol));
 
     return result;
@@ -274,6 +274,32 @@ auto queryAllSymbols(CodeDocument *const document) -> QList<Core::Symbol *>
 
 namespace Core {
 
+Symbol::Kind cppFunctionKind(bool hasReturnType, const QString &name)
+{
+    if (!hasReturnType) {
+        // No return type, this is a Constructor/Destructor
+        // Clangd also assigned the Constructor kind to Destructors, so we'll do the same
+        return Symbol::Kind::Constructor;
+    } else if (name.contains("::")) {
+        // This is a bit of a guesstimate, but if the function name contains "::", it's likely a method.
+        // It may also be a member of a namespace, but this information isn't really available unless we try
+        // to resolve the original declaration.
+        return Symbol::Kind::Method;
+    }
+    return Symbol::Kind::Function;
+}
+
+QList<SymbolQuery> cppSymbolQueries()
+{
+    return {
+        {.kind = Symbol::Kind::Class, .query = classQuery(std::nullopt)},
+        {.kind = Symbol::Kind::Function, .query = functionsQuery()},
+        {.kind = Symbol::Kind::Field, .query = membersQuery(std::nullopt)},
+        {.kind = Symbol::Kind::Enum, .query = enumQuery},
+        {.kind = Symbol::Kind::Enum, .query = enumeratorQuery},
+    };
+}
+
 /*!
  * \qmltype CppDocument
  * \brief Document object for a C++ file (source or header)
@@ -1777,27 +1803,42 @@ QStringList CppDocument::primitiveTypes() const
 
 QList<treesitter::Range> CppDocument::includedRanges() const
 {
-    auto macros = Settings::instance()->value<QStringList>(Settings::CppExcludedMacros);
-    if (macros.isEmpty()) {
+    return cppIncludedRanges(textEdit()->toPlainText(),
+                             Settings::instance()->value<QStringList>(Settings::CppExcludedMacros));
+}
+
+/**
+ * Returns the ranges of `text` to parse, skipping all the `excludedMacros`.
+ * This function doesn't depend on any document, so it can be used from any thread.
+ */
+QList<treesitter::Range> cppIncludedRanges(const QString &text, const QStringList &excludedMacros)
+{
+    if (excludedMacros.isEmpty()) {
         return {};
     }
 
-    QRegularExpression regex(macros.join("|"));
+    QRegularExpression regex(excludedMacros.join("|"));
     if (!regex.isValid()) {
         spdlog::error("{}: Failed to create regex for excluded macros: {}", FUNCTION_NAME, regex.errorString());
         return {};
     }
 
-    auto document = textEdit()->document();
-
     QList<treesitter::Range> ranges;
     treesitter::Point lastPoint {0, 0};
     uint32_t lastByte = 0;
 
-    for (auto block = document->firstBlock(); block.isValid(); block = block.next()) {
+    // Same as the blocks of a QTextDocument: each line, with its position and its length (including the '\n')
+    uint32_t blockNumber = 0;
+    qsizetype blockPosition = 0;
+    qsizetype blockLength = 0;
+    for (const auto blockText : qTokenize(text, u'\n')) {
+        blockPosition += blockLength;
+        blockLength = blockText.size() + 1;
+        const uint32_t row = blockNumber++;
+
         QRegularExpressionMatch match;
-        auto searchFrom = 0;
-        auto index = block.text().indexOf(regex, searchFrom, &match);
+        qsizetype searchFrom = 0;
+        auto index = blockText.indexOf(regex, searchFrom, &match);
 
         // Run this in a loop to support multiple macros on the same line.
         while (index != -1) {
@@ -1808,38 +1849,35 @@ QList<treesitter::Range> CppDocument::includedRanges() const
             // Also Note that the column seems to be in bytes, not characters.
             // This is why we multiply by sizeof(QChar) to get the correct column.
             // At least that's what the TreeSitterInspector shows us.
-            auto endPoint = treesitter::Point {.row = static_cast<uint32_t>(block.blockNumber()),
-                                               .column = static_cast<uint32_t>(index * sizeof(QChar))};
+            auto endPoint = treesitter::Point {.row = row, .column = static_cast<uint32_t>(index * sizeof(QChar))};
             ranges.push_back({.start_point = lastPoint,
                               .end_point = endPoint,
                               .start_byte = lastByte,
                               // No need to add - 1 here, the ranges are exclusive at the end.
-                              .end_byte = static_cast<uint32_t>((block.position() + index) * sizeof(QChar))});
+                              .end_byte = static_cast<uint32_t>((blockPosition + index) * sizeof(QChar))});
 
             auto matchLength = match.capturedLength();
-            lastByte = static_cast<uint32_t>((block.position() + index + matchLength) * sizeof(QChar));
-            lastPoint = {.row = static_cast<uint32_t>(block.blockNumber()),
-                         .column = static_cast<uint32_t>((index + matchLength) * sizeof(QChar))};
-            if (lastPoint.column == static_cast<uint32_t>(block.length())) {
+            lastByte = static_cast<uint32_t>((blockPosition + index + matchLength) * sizeof(QChar));
+            lastPoint = {.row = row, .column = static_cast<uint32_t>((index + matchLength) * sizeof(QChar))};
+            if (lastPoint.column == static_cast<uint32_t>(blockLength)) {
                 ++lastPoint.row;
                 lastPoint.column = 0;
             }
 
             searchFrom = index + matchLength;
-            index = block.text().indexOf(regex, searchFrom, &match);
+            index = blockText.indexOf(regex, searchFrom, &match);
         }
     }
 
     if (!ranges.isEmpty()) {
         // Add the last range, up to the end of the document, but only if we have another range.
         // Leaving the ranges empty will parse the entire document, so that's easiest.
-        auto endPoint =
-            treesitter::Point {.row = static_cast<uint32_t>(document->blockCount() - 1),
-                               .column = static_cast<uint32_t>(document->lastBlock().length() * sizeof(QChar))};
+        auto endPoint = treesitter::Point {.row = blockNumber - 1,
+                                           .column = static_cast<uint32_t>(blockLength * sizeof(QChar))};
         ranges.push_back({.start_point = lastPoint,
                           .end_point = endPoint,
                           .start_byte = lastByte,
-                          .end_byte = static_cast<uint32_t>(document->characterCount() * sizeof(QChar))});
+                          .end_byte = static_cast<uint32_t>((text.size() + 1) * sizeof(QChar))});
     }
 
     return ranges;
@@ -10,6 +10,8 @@
 
 #pragma once
 
+#include "symbol.h"
+#include "treesitter/parser.h"
 #include "utils/json.h"
 
 #include <map>
@@ -58,6 +60,19 @@ namespace Queries {
 
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(ToggleSectionSettings, tag, debug, return_values);
 
+//! Query used to find symbols of one kind in a C++ file
+struct SymbolQuery
+{
+    Symbol::Kind kind;
+    QString query;
+};
+
+// Queries used to find all symbols in a C++ file, shared by CppDocument and DocumentSnapshot
+QList<SymbolQuery> cppSymbolQueries();
+// Functions are refined using the return type and the name of the function
+Symbol::Kind cppFunctionKind(bool hasReturnType, const QString &name);
+QList<treesitter::Range> cppIncludedRanges(const QString &text, const QStringList &excludedMacros);
+
 class IncludeHelper
 {
 public:
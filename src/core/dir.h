@@ -108,6 +108,9 @@ signals:
     void currentPathChanged(const QString &path);
 
 private:
+    friend class ScriptRunner;
+    void setCurrentScriptPath(const QString &path) { m_currentScriptPath = path; }
+
     QString m_currentScriptPath;
 };
 
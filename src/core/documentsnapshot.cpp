@@ -0,0 +1,335 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "documentsnapshot.h"
+#include "cppdocument_p.h"
+#include "treesitter/parser.h"
+#include "treesitter/predicates.h"
+#include "treesitter/query.h"
+#include "treesitter/tree.h"
+#include "utils/log.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QVariantMap>
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+namespace Core {
+
+/*!
+ * \qmltype DocumentSnapshot
+ * \brief Read-only snapshot of a file, used to analyze many files in parallel.
+ * \ingroup CodeDocument
+ * \sa Project::analyzeFiles
+ *
+ * A snapshot contains the text of a file, its syntax tree and its symbols. Unlike documents, a snapshot is not opened
+ * in the project and can't be changed: it is created by `Project.analyzeFiles`, on a worker thread.
+ *
+ * Positions are character positions in the text, like for a `RangeMark`. Only C++ and QML files have a syntax tree,
+ * and symbols are only available for C++ files.
+ */
+
+/*!
+ * \qmlproperty bool DocumentSnapshot::isValid
+ * Returns true if the file has been read.
+ */
+/*!
+ * \qmlproperty string DocumentSnapshot::fileName
+ * Name of the file of the snapshot.
+ */
+/*!
+ * \qmlproperty string DocumentSnapshot::text
+ * Text of the file.
+ */
+/*!
+ * \qmlproperty array<object> DocumentSnapshot::symbols
+ * List of all symbols of the file, sorted by position. Each symbol is an object with the following properties:
+ *
+ * - `name`: full name of the symbol, including its surrounding classes
+ * - `kind`: kind of symbol, see `Symbol.kind`
+ * - `start`, `end`: range of the symbol
+ */
+
+struct DocumentSnapshot::Data
+{
+    QString fileName;
+    Document::Type type = Document::Type::Text;
+    QString text;
+    std::optional<treesitter::Tree> tree;
+
+    // Symbols are only computed when needed, by the first thread asking for them
+    mutable std::once_flag symbolsFlag;
+    mutable QList<SymbolInfo> symbols;
+};
+
+static bool hasSyntaxTree(Document::Type type)
+{
+    return type == Document::Type::Cpp || type == Document::Type::Qml;
+}
+
+// Parsers and queries are not thread-safe, each thread has its own
+static treesitter::Parser &threadParser(Document::Type type)
+{
+    thread_local std::map<Document::Type, treesitter::Parser> parsers;
+    auto it = parsers.find(type);
+    if (it == parsers.end())
+        it = parsers.emplace(type, treesitter::Parser(treesitter::Parser::getLanguage(type))).first;
+    return it->second;
+}
+
+static std::shared_ptr<treesitter::Query> threadQuery(Document::Type type, const QString &query)
+{
+    // Invalid queries are stored too, so the error is only logged once
+    static constexpr size_t MaxQueries = 64;
+    thread_local std::map<std::pair<Document::Type, QString>, std::shared_ptr<treesitter::Query>> queries;
+
+    const auto key = std::make_pair(type, query);
+    auto it = queries.find(key);
+    if (it != queries.end())
+        return it->second;
+
+    if (queries.size() >= MaxQueries)
+        queries.clear();
+
+    std::shared_ptr<treesitter::Query> tsQuery;
+    try {
+        tsQuery = std::make_shared<treesitter::Query>(threadParser(type).language(), query);
+    } catch (treesitter::Query::Error &error) {
+        spdlog::error("{}: Failed to parse query `{}` error: {} at: {}", FUNCTION_NAME, query, error.description,
+                      error.utf8_offset);
+    }
+    queries.emplace(key, tsQuery);
+    return tsQuery;
+}
+
+/**
+ * Loads `fileName` and parses it. The C++ `excludedMacros` are skipped when parsing, like for a CppDocument.
+ * Returns an invalid snapshot if the file can't be read.
+ */
+DocumentSnapshot DocumentSnapshot::fromFile(const QString &fileName, Document::Type type,
+                                            const QStringList &excludedMacros)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        spdlog::warn("{}: Can't load file {}: {}", FUNCTION_NAME, fileName, file.errorString());
+        return {};
+    }
+
+    const QByteArray data = file.readAll();
+    QTextStream stream(data);
+    QString text = stream.readAll();
+    // Same as a TextDocument
+    text.replace(QLatin1String("\r\n"), QLatin1String("\n"));
+    return fromText(fileName, text, type, excludedMacros);
+}
+
+DocumentSnapshot DocumentSnapshot::fromText(const QString &fileName, const QString &text, Document::Type type,
+                                            const QStringList &excludedMacros)
+{
+    auto data = std::make_shared<Data>();
+    data->fileName = fileName;
+    data->type = type;
+    data->text = text;
+
+    if (hasSyntaxTree(type)) {
+        auto &parser = threadParser(type);
+        const auto ranges = type == Document::Type::Cpp ? cppIncludedRanges(text, excludedMacros)
+                                                        : QList<treesitter::Range> {};
+        if (!parser.setIncludedRanges(ranges)) {
+            spdlog::warn("{}: Unable to set the included ranges on the treesitter parser!", FUNCTION_NAME);
+            parser.setIncludedRanges({});
+        }
+        data->tree = parser.parseString(text);
+        if (!data->tree)
+            spdlog::warn("{}: Failed to parse document {}!", FUNCTION_NAME, fileName);
+    }
+
+    DocumentSnapshot snapshot;
+    snapshot.m_data = std::move(data);
+    return snapshot;
+}
+
+bool DocumentSnapshot::isValid() const
+{
+    return m_data != nullptr;
+}
+
+QString DocumentSnapshot::fileName() const
+{
+    return m_data ? m_data->fileName : QString();
+}
+
+Document::Type DocumentSnapshot::type() const
+{
+    return m_data ? m_data->type : Document::Type::Text;
+}
+
+QString DocumentSnapshot::text() const
+{
+    return m_data ? m_data->text : QString();
+}
+
+QString DocumentSnapshot::textAt(int start, int end) const
+{
+    if (!m_data || start < 0 || end < start)
+        return {};
+    return m_data->text.mid(start, end - start);
+}
+
+std::optional<treesitter::Tree> DocumentSnapshot::syntaxTree() const
+{
+    if (!m_data || !m_data->tree)
+        return {};
+    return m_data->tree->copy();
+}
+
+/**
+ * Runs the tree-sitter `query` on the snapshot, and returns the captures of each match.
+ * This can be called from any thread, queries are compiled once per thread.
+ */
+QList<DocumentSnapshot::Match> DocumentSnapshot::queryMatches(const QString &query) const
+{
+    // Each call uses its own copy of the tree, as trees are not thread-safe
+    auto tree = syntaxTree();
+    if (!tree)
+        return {};
+    auto tsQuery = threadQuery(m_data->type, query);
+    if (!tsQuery)
+        return {};
+
+    treesitter::QueryCursor cursor;
+    cursor.execute(tsQuery, tree->rootNode(), std::make_unique<treesitter::Predicates>(m_data->text));
+    const auto matches = cursor.allRemainingMatches();
+
+    QList<Match> result;
+    result.reserve(matches.size());
+    for (const auto &match : matches) {
+        Match captures;
+        const auto matchCaptures = match.captures();
+        for (const auto &capture : matchCaptures) {
+            captures.push_back({.name = tsQuery->captureAt(capture.id).name,
+                                .start = static_cast<int>(capture.node.startPosition()),
+                                .end = static_cast<int>(capture.node.endPosition())});
+        }
+        result.push_back(std::move(captures));
+    }
+    return result;
+}
+
+static const DocumentSnapshot::Capture *findCapture(const DocumentSnapshot::Match &match, const QString &name)
+{
+    auto it = std::ranges::find(match, name, &DocumentSnapshot::Capture::name);
+    return it == match.cend() ? nullptr : &(*it);
+}
+
+/**
+ * Returns the symbols of the snapshot, computed with the same queries as CppDocument.
+ */
+const QList<DocumentSnapshot::SymbolInfo> &DocumentSnapshot::symbols() const
+{
+    static const QList<SymbolInfo> empty;
+    if (!m_data || m_data->type != Document::Type::Cpp)
+        return empty;
+
+    std::call_once(m_data->symbolsFlag, [this]() {
+        QList<SymbolInfo> symbols;
+        const auto symbolQueries = cppSymbolQueries();
+        for (const auto &symbolQuery : symbolQueries) {
+            const auto matches = queryMatches(symbolQuery.query);
+            for (const auto &match : matches) {
+                const auto name = findCapture(match, "name");
+                const auto range = findCapture(match, "range");
+                if (!name || !range)
+                    continue;
+                SymbolInfo symbol {.name = textAt(name->start, name->end),
+                                   .kind = symbolQuery.kind,
+                                   .start = range->start,
+                                   .end = range->end};
+                if (symbol.kind == Symbol::Kind::Function)
+                    symbol.kind = cppFunctionKind(findCapture(match, "return") != nullptr, symbol.name);
+                symbols.push_back(std::move(symbol));
+            }
+        }
+        std::ranges::stable_sort(symbols, {}, &SymbolInfo::start);
+
+        // Same as TreeSitterHelper::assignSymbolContexts: prefix the name with all the surrounding symbols
+        const auto originalSymbols = symbols;
+        for (auto &symbol : symbols) {
+            QList<const SymbolInfo *> contexts;
+            for (const auto &other : originalSymbols) {
+                const bool isSame = other.start == symbol.start && other.end == symbol.end && other.name == symbol.name;
+                if (!isSame && other.start <= symbol.start && symbol.end <= other.end)
+                    contexts.push_back(&other);
+            }
+            if (contexts.isEmpty())
+                continue;
+            std::ranges::stable_sort(contexts, [](const SymbolInfo *lhs, const SymbolInfo *rhs) {
+                return (lhs->end - lhs->start) > (rhs->end - rhs->start);
+            });
+            QStringList names;
+            bool inClass = false;
+            for (const auto context : std::as_const(contexts)) {
+                names.push_back(context->name);
+                inClass |= context->kind == Symbol::Kind::Class;
+            }
+            symbol.name = names.join("::") + "::" + symbol.name;
+            if (symbol.kind == Symbol::Kind::Function && inClass)
+                symbol.kind = Symbol::Kind::Method;
+        }
+        m_data->symbols = std::move(symbols);
+    });
+    return m_data->symbols;
+}
+
+/*!
+ * \qmlmethod array<object> DocumentSnapshot::query(string query)
+ * Runs the given Tree-sitter `query` and returns the list of matches.
+ *
+ * Each match is an object with a `captures` property, the list of all captures of the match. Each capture has a
+ * `name`, a `text`, and a `start` and `end` position.
+ *
+ * ```js
+ * let matches = snapshot.query("(function_definition declarator: (_) @name)");
+ * for (let match of matches)
+ *     Message.log(match.captures[0].text);
+ * ```
+ */
+QVariantList DocumentSnapshot::query(const QString &query) const
+{
+    QVariantList result;
+    const auto matches = queryMatches(query);
+    for (const auto &match : matches) {
+        QVariantList captures;
+        for (const auto &capture : match) {
+            captures.push_back(QVariantMap {{"name", capture.name},
+                                            {"text", textAt(capture.start, capture.end)},
+                                            {"start", capture.start},
+                                            {"end", capture.end}});
+        }
+        result.push_back(QVariantMap {{"captures", captures}});
+    }
+    return result;
+}
+
+QVariantList DocumentSnapshot::symbolList() const
+{
+    QVariantList result;
+    for (const auto &symbol : symbols()) {
+        result.push_back(QVariantMap {{"name", symbol.name},
+                                      {"kind", static_cast<int>(symbol.kind)},
+                                      {"start", symbol.start},
+                                      {"end", symbol.end}});
+    }
+    return result;
+}
+
+} // namespace Core
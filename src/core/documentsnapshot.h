@@ -0,0 +1,95 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include "document.h"
+#include "symbol.h"
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+#include <memory>
+#include <optional>
+
+namespace treesitter {
+class Tree;
+}
+
+namespace Core {
+
+/**
+ * @brief Read-only snapshot of a file, with its text, syntax tree and symbols
+ *
+ * A snapshot doesn't depend on the project or on any document: it can be created on any thread, and the same snapshot
+ * can be queried concurrently from multiple threads. Copies are cheap, they share the same data.
+ */
+class DocumentSnapshot
+{
+    Q_GADGET
+
+    Q_PROPERTY(bool isValid READ isValid CONSTANT FINAL)
+    Q_PROPERTY(QString fileName READ fileName CONSTANT FINAL)
+    Q_PROPERTY(QString text READ text CONSTANT FINAL)
+    Q_PROPERTY(QVariantList symbols READ symbolList CONSTANT FINAL)
+
+public:
+    struct Capture
+    {
+        QString name;
+        int start = -1;
+        int end = -1;
+    };
+    using Match = QList<Capture>;
+
+    struct SymbolInfo
+    {
+        QString name;
+        Symbol::Kind kind;
+        int start = -1;
+        int end = -1;
+    };
+
+    // Default constructor is required for Q_DECLARE_METATYPE
+    DocumentSnapshot() = default;
+
+    // Only C++ and QML files have a syntax tree
+    static DocumentSnapshot fromFile(const QString &fileName, Document::Type type,
+                                     const QStringList &excludedMacros = {});
+    static DocumentSnapshot fromText(const QString &fileName, const QString &text, Document::Type type,
+                                     const QStringList &excludedMacros = {});
+
+    bool isValid() const;
+    QString fileName() const;
+    Document::Type type() const;
+    QString text() const;
+    QString textAt(int start, int end) const;
+
+    // Returns a copy of the syntax tree, owned by the caller, or an empty optional if there's none.
+    std::optional<treesitter::Tree> syntaxTree() const;
+
+    QList<Match> queryMatches(const QString &query) const;
+    const QList<SymbolInfo> &symbols() const;
+
+    Q_INVOKABLE QVariantList query(const QString &query) const;
+
+private:
+    struct Data;
+
+    QVariantList symbolList() const;
+
+    std::shared_ptr<const Data> m_data;
+};
+
+} // namespace Core
+
+Q_DECLARE_METATYPE(Core::DocumentSnapshot)
@@ -9,6 +9,7 @@
 */
 
 #include "knutcore.h"
+#include "profiler.h"
 #include "project.h"
 #include "scriptmanager.h"
 #include "textdocument.h"
@@ -16,6 +17,7 @@
 #include <QAbstractItemModel>
 #include <QApplication>
 #include <QDir>
+#include <QFile>
 #include <QTimer>
 #include <iostream>
 #include <nlohmann/json.hpp>
@@ -54,6 +56,7 @@ bool KnutCore::process(const QStringList &arguments)
     const bool jsonList = parser.isSet("json-list");
     if (jsonList) {
         initialize(Settings::Mode::Cli);
+        ScriptManager::instance()->waitForScripts();
         auto model = Core::ScriptManager::model();
         if (model->rowCount() == 0) {
             std::cout << "[]\n";
@@ -71,6 +74,12 @@ bool KnutCore::process(const QStringList &arguments)
         exit(0);
     }
 
+    if (parser.isSet("precompile-scripts")) {
+        initialize(Settings::Mode::Cli);
+        const int errors = ScriptManager::instance()->precompileScripts();
+        exit(errors == 0 ? 0 : 1);
+    }
+
     const bool jsonSettings = parser.isSet("json-settings");
     if (jsonSettings) {
         initialize(Settings::Mode::Cli);
@@ -92,6 +101,15 @@ bool KnutCore::process(const QStringList &arguments)
 
     initialize(mode);
 
+    // Profile all API calls, the trace is written when leaving Knut
+    const QString profileFileName = parser.value("profile");
+    if (!profileFileName.isEmpty()) {
+        Profiler::setEnabled(true);
+        connect(qApp, &QCoreApplication::aboutToQuit, this, [profileFileName]() {
+            Profiler::writeTrace(profileFileName);
+        });
+    }
+
     const QStringList positionalArguments = parser.positionalArguments();
     // Set the root directory
     if (!positionalArguments.isEmpty()) {
@@ -173,8 +191,10 @@ void KnutCore::initParser(QCommandLineParser &parser) const
                        {{"l", "line"}, "Line in the current file, if any.", "line"},
                        {{"c", "column"}, "Column in the current file, if any.", "column"},
                        {{"d", "data"}, "JSON data string for initializing the dialog.", "data"},
+                       {"profile", "Profiles all API calls and writes a Chrome trace in <file> when leaving.", "file"},
                        {"json-list", "Returns the list of all available scripts as a JSON file"},
-                       {"json-settings", "Returns the settings as a JSON file"}});
+                       {"json-settings", "Returns the settings as a JSON file"},
+                       {"precompile-scripts", "Compiles all available scripts and stores them in the script cache"}});
 }
 
 void KnutCore::doParse(const QCommandLineParser &parser) const
@@ -190,6 +210,7 @@ void KnutCore::initialize(Settings::Mode mode)
         return;
     new Settings(mode, this);
     new Project(this);
+    initializeScriptCache();
     new ScriptManager(this);
     if (Core::Settings::instance()->value<bool>(Core::Settings::SaveLogsToFile))
         initializeMultiSinkLogger();
@@ -198,6 +219,17 @@ void KnutCore::initialize(Settings::Mode mode)
     m_initialized = true;
 }
 
+void KnutCore::initializeScriptCache()
+{
+    // Store the compiled scripts in a cache specific to this Knut version, unless a cache is already set by the user.
+    // This needs to be done before creating any QML engine.
+    if (qEnvironmentVariableIsSet("QML_DISK_CACHE_PATH"))
+        return;
+    const QString cachePath = Settings::instance()->scriptCachePath();
+    QDir().mkpath(cachePath);
+    qputenv("QML_DISK_CACHE_PATH", QFile::encodeName(cachePath));
+}
+
 void KnutCore::initializeMultiSinkLogger()
 {
     // Define fileLogger arguments (make it clear)
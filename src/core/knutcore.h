@@ -38,6 +38,7 @@ protected:
 
 private:
     void initialize(Settings::Mode mode);
+    void initializeScriptCache();
     void initializeMultiSinkLogger();
 
     bool m_initialized = false;
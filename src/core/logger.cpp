@@ -14,11 +14,13 @@
 #include "textdocument_p.h"
 
 #include <QHash>
+#include <QTextStream>
 
 namespace Core {
 
-LoggerObject::LoggerObject()
+LoggerObject::LoggerObject(const QString &location)
     : m_firstLogger(m_canLog)
+    , m_profilerScope(location, Profiler::Api)
 {
 }
 
@@ -28,16 +30,20 @@ LoggerObject::~LoggerObject()
         m_canLog = true;
 }
 
-void LoggerObject::log(QString &&string)
-{
-    spdlog::trace(string);
-    m_canLog = false;
-}
-
 HistoryModel::HistoryModel(QObject *parent)
     : QAbstractTableModel(parent)
 {
     LoggerObject::m_model = this;
+
+    auto updateLimit = [this]() {
+        setLimit(DEFAULT_VALUE(int, HistoryLimit));
+    };
+    updateLimit();
+    connect(Settings::instance(), &Settings::settingsLoaded, this, updateLimit);
+    connect(Settings::instance(), &Settings::settingsChanged, this, [updateLimit](const QString &path) {
+        if (path == Settings::HistoryLimit)
+            updateLimit();
+    });
 }
 
 HistoryModel::~HistoryModel()
@@ -64,18 +70,20 @@ QVariant HistoryModel::data(const QModelIndex &index, int role) const
     if (role == Qt::DisplayRole) {
         switch (index.column()) {
         case NameCol:
-            return m_data.at(index.row()).name;
+            return m_names.at(m_data.at(index.row()).nameId);
         case ParamCol: {
-            const auto &params = m_data.at(index.row()).params;
-            QStringList paramStrings;
-            for (const auto &param : params) {
-                QString text = param.value;
+            const auto &data = m_data.at(index.row());
+            QString text;
+            for (const auto &param : data.params()) {
+                if (!text.isEmpty())
+                    text += QLatin1String(", ");
                 if (!param.name.isEmpty())
-                    text.prepend(QString("%1: ").arg(param.name));
-                paramStrings.push_back(text);
+                    text += param.name + QLatin1String(": ");
+                text += param.value;
             }
-            const QString returnVariable = m_data.at(index.row()).returnArg.name;
-            return paramStrings.join(", ") + (returnVariable.isEmpty() ? "" : (" => " + returnVariable));
+            if (!data.returnArg.isEmpty())
+                text += QLatin1String(" => ") + data.returnArg.name;
+            return text;
         }
         }
     }
@@ -100,10 +108,36 @@ void HistoryModel::clear()
 {
     beginResetModel();
     m_data.clear();
+    m_names.clear();
+    m_nameIds.clear();
     endResetModel();
 }
 
+int HistoryModel::limit() const
+{
+    return m_limit;
+}
+
+void HistoryModel::setLimit(int limit)
+{
+    m_limit = limit;
+    if (m_limit > 0 && static_cast<int>(m_data.size()) > m_limit)
+        removeFirstRows(static_cast<int>(m_data.size()) - m_limit);
+}
+
 QString HistoryModel::createScript(int start, int end)
+{
+    QString scriptText;
+    QTextStream stream(&scriptText);
+    createScript(start, end, stream);
+    stream.flush();
+    return scriptText;
+}
+
+/**
+ * Writes the script directly in the `stream`, without building the whole script in memory first.
+ */
+void HistoryModel::createScript(int start, int end, QTextStream &stream)
 {
     const auto settings = Core::Settings::instance()->value<Core::TabSettings>(Core::Settings::Tab);
     const auto tab = settings.insertSpaces ? QString(settings.tabSize, ' ') : QString('\t');
@@ -111,19 +145,20 @@ QString HistoryModel::createScript(int start, int end)
     std::tie(start, end) = std::minmax(start, end);
     Q_ASSERT(start >= 0 && start <= end && end < static_cast<int>(m_data.size()));
 
-    QString scriptText = "// Description of the script\n\nfunction main() {\n";
+    stream << "// Description of the script\n\nfunction main() {\n";
 
     QHash<QString, QVariant> returnVariables;
 
     for (int row = start; row <= end; ++row) {
         const auto &data = m_data.at(row);
-        QString apiCall = data.name;
+        const QString &apiName = m_names.at(data.nameId);
+        QString apiCall = apiName;
         const bool isProperty = ScriptRunner::isProperty(apiCall);
 
         // Check if we need to create the document, and change the API call as it's not a singleton
-        if (data.name.contains("Document::")) {
+        if (apiName.contains("Document::")) {
             if (!returnVariables.contains("document"))
-                scriptText += tab + "var document = Project.currentDocument\n";
+                stream << tab << "var document = Project.currentDocument\n";
             returnVariables["document"] = {};
             apiCall = "document." + apiCall.mid(apiCall.indexOf("::") + 2);
         } else {
@@ -139,28 +174,27 @@ QString HistoryModel::createScript(int start, int end)
         }
 
         // Pass the parameters
-        QStringList paramStrings;
-        for (const auto &param : data.params) {
-            if (!param.name.isEmpty() && returnVariables.value(param.name) == param.value) {
-                paramStrings.append(param.name);
-                continue;
-            }
-
-            paramStrings.push_back(param.value);
-        }
-
+        auto paramString = [&returnVariables](const Arg &param) -> const QString & {
+            if (!param.name.isEmpty() && returnVariables.value(param.name) == param.value)
+                return param.name;
+            return param.value;
+        };
+        const auto &params = data.params();
+
+        stream << tab << returnValue << apiCall;
         if (isProperty) {
-            if (paramStrings.isEmpty())
-                scriptText += tab + returnValue + apiCall + '\n';
-            else
-                scriptText += tab + returnValue + QString("%1 = %2\n").arg(apiCall, paramStrings.first());
+            if (!params.empty())
+                stream << " = " << paramString(params.front());
         } else {
-            scriptText += tab + returnValue + QString("%1(%2)\n").arg(apiCall, paramStrings.join(", "));
+            stream << '(';
+            for (size_t i = 0; i < params.size(); ++i)
+                stream << (i == 0 ? "" : ", ") << paramString(params[i]);
+            stream << ')';
         }
+        stream << '\n';
     }
 
-    scriptText += "}\n";
-    return scriptText;
+    stream << "}\n";
 }
 
 QString HistoryModel::createScript(const QModelIndex &startIndex, const QModelIndex &endIndex)
@@ -170,14 +204,24 @@ QString HistoryModel::createScript(const QModelIndex &startIndex, const QModelIn
     return createScript(startIndex.row(), endIndex.row());
 }
 
-void HistoryModel::logData(const QString &name)
+int HistoryModel::nameId(const QString &name)
 {
-    addData(LogData {name, {}, {}}, false);
+    auto it = m_nameIds.constFind(name);
+    if (it != m_nameIds.cend())
+        return it.value();
+    const auto id = static_cast<int>(m_names.size());
+    m_names.push_back(name);
+    m_nameIds.insert(name, id);
+    return id;
 }
 
 void HistoryModel::addData(LogData &&data, bool merge)
 {
-    if (!merge || m_data.empty() || m_data.back().name != data.name) {
+    if (!merge || m_data.empty() || m_data.back().nameId != data.nameId) {
+        // Make room for the new call, the history works as a ring buffer
+        if (m_limit > 0 && static_cast<int>(m_data.size()) >= m_limit)
+            removeFirstRows(static_cast<int>(m_data.size()) - m_limit + 1);
+
         beginInsertRows({}, static_cast<int>(m_data.size()), static_cast<int>(m_data.size()));
         m_data.push_back(std::move(data));
         endInsertRows();
@@ -185,19 +229,25 @@ void HistoryModel::addData(LogData &&data, bool merge)
     }
 
     auto &lastData = m_data.back();
+    auto &lastParams = lastData.params();
     // Add parameters together
-    for (size_t i = 0; i < data.params.size(); ++i) {
-        const auto &param = data.params[i];
-        auto &lastParam = lastData.params[i];
+    const auto &params = data.params();
+    for (size_t i = 0; i < params.size(); ++i) {
+        const auto &param = params[i];
+        auto &lastParam = lastParams[i];
         switch (static_cast<QMetaType::Type>(param.type)) {
         case QMetaType::Int:
             lastParam.value = QString::number(lastParam.value.toInt() + param.value.toInt());
             break;
+        // Values are merged in place, to avoid copying the whole string each time
         case QMetaType::QString:
-            lastParam.value = lastParam.value.chopped(1) + param.value.sliced(1);
+            lastParam.value.chop(1);
+            lastParam.value.append(QStringView(param.value).sliced(1));
             break;
         case QMetaType::QStringList:
-            lastParam.value = lastParam.value.chopped(1) + ", " + param.value.sliced(1);
+            lastParam.value.chop(1);
+            lastParam.value.append(QLatin1String(", "));
+            lastParam.value.append(QStringView(param.value).sliced(1));
             break;
         default:
             Q_UNREACHABLE();
@@ -207,6 +257,13 @@ void HistoryModel::addData(LogData &&data, bool merge)
     emit dataChanged(lastIndex, lastIndex);
 }
 
+void HistoryModel::removeFirstRows(int count)
+{
+    beginRemoveRows({}, 0, count - 1);
+    m_data.erase(m_data.begin(), m_data.begin() + count);
+    endRemoveRows();
+}
+
 LoggerDisabler::LoggerDisabler(bool silenceAll)
     : m_originalCanLog(LoggerObject::m_canLog)
     , m_silenceAll(silenceAll)
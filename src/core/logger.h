@@ -10,36 +10,56 @@
 
 #pragma once
 
+#include "profiler.h"
 #include "scriptdialogitem.h"
 #include "utils/log.h"
 
 #include <QAbstractItemModel>
 #include <QCoreApplication>
+#include <QHash>
 #include <QMetaEnum>
 #include <QString>
+#include <QStringList>
 #include <QVariantList>
 #include <concepts>
+#include <deque>
+#include <functional>
+#include <tuple>
 #include <vector>
 
+class QTextStream;
+
 /**
  * Create a return value, the name will depend on the type returned.
  */
 #define LOG_ARG(name, value) Core::LoggerArg(name, value)
 
+/**
+ * Name of the method calling the macro, computed only once for each call site.
+ */
+#define LOG_LOCATION                                                                                                   \
+    [](const std::source_location &__location) -> const QString & {                                                    \
+        static const QString __name = Core::formatToClassNameFunctionName(__location);                                 \
+        return __name;                                                                                                 \
+    }(std::source_location::current())
+
 /**
  * Log a method, with all its parameters.
+ * The parameters are only evaluated if the call is recorded (in the history or in the trace logs).
  */
 #define LOG(...)                                                                                                       \
-    Core::LoggerObject __loggerObject(Core::formatToClassNameFunctionName(std::source_location::current()), false,     \
-                                      ##__VA_ARGS__)
+    Core::LoggerObject __loggerObject(LOG_LOCATION, false, [&]() {                                                     \
+        return std::make_tuple(__VA_ARGS__);                                                                           \
+    })
 
 /**
  * Log a method, with all its parameters. If the previous log is also the same method, it will be merged into one
  * operation
  */
 #define LOG_AND_MERGE(...)                                                                                             \
-    Core::LoggerObject __loggerObject(Core::formatToClassNameFunctionName(std::source_location::current()), true,      \
-                                      ##__VA_ARGS__)
+    Core::LoggerObject __loggerObject(LOG_LOCATION, true, [&]() {                                                      \
+        return std::make_tuple(__VA_ARGS__);                                                                           \
+    })
 
 /**
  * Macro to save the returned value in the historymodel
@@ -147,16 +167,24 @@ struct LoggerArgBase
 template <typename T>
 struct LoggerArg : public LoggerArgBase
 {
-    LoggerArg(QString &&name, T v)
+    LoggerArg(const char *name, T v)
         : argName(name)
-        , value(v)
+        , value(std::move(v))
     {
     }
-    QString argName;
+    const char *argName;
     T value;
     QString toString() const { return valueToString(value); }
 };
 
+/**
+ * Values which can be formatted later: they are copied and don't depend on any other object.
+ * Other values (marks, JS values...) are formatted when the call is recorded.
+ */
+template <typename T>
+concept IsPlainValue = std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_same_v<T, QString>
+    || std::is_same_v<T, QStringList> || std::is_same_v<T, QFlags<typename T::enum_type>>;
+
 class HistoryModel : public QAbstractTableModel
 {
     Q_OBJECT
@@ -174,12 +202,20 @@ public:
 
     void clear();
 
+    /**
+     * @brief Maximum number of API calls kept in the history, the oldest ones are removed first
+     * A limit of 0 or less means no limit.
+     */
+    int limit() const;
+    void setLimit(int limit);
+
     /**
      * @brief Create a script from 2 points in the history
      * The script is created using 2 rows in the history model. It will create a javascript script.
      */
     QString createScript(int start, int end);
     QString createScript(const QModelIndex &startIndex, const QModelIndex &endIndex);
+    void createScript(int start, int end, QTextStream &stream);
 
 private:
     friend class LoggerObject;
@@ -198,18 +234,48 @@ private:
     };
     struct LogData
     {
-        QString name;
-        std::vector<Arg> params;
+        // Index in m_names, API names are shared by all calls
+        int nameId = -1;
         ReturnArg returnArg;
+
+        // Parameters are only formatted when they are needed, the first time params() is called
+        const std::vector<Arg> &params() const
+        {
+            if (formatParams) {
+                formattedParams = formatParams();
+                formatParams = nullptr;
+            }
+            return formattedParams;
+        }
+        std::vector<Arg> &params()
+        {
+            std::as_const(*this).params();
+            return formattedParams;
+        }
+
+        mutable std::function<std::vector<Arg>()> formatParams;
+        mutable std::vector<Arg> formattedParams;
     };
 
-    void logData(const QString &name);
     template <typename... Ts>
-    void logData(const QString &name, bool merge, Ts... params)
+    void logData(const QString &name, bool merge, std::tuple<Ts...> &&params)
     {
         LogData data;
-        data.name = name;
-        fillLogData(data, params...);
+        data.nameId = nameId(name);
+        if constexpr (sizeof...(Ts) > 0) {
+            // Only plain values are kept as is, others are formatted now as they could change
+            data.formatParams = [params = std::apply(
+                                     [](auto &&...param) {
+                                         return std::make_tuple(deferArg(std::move(param))...);
+                                     },
+                                     std::move(params))]() {
+                return std::apply(
+                    [](const auto &...param) {
+                        return std::vector<Arg> {toArg(param)...};
+                    },
+                    params);
+            };
+        }
         addData(std::move(data), merge);
     }
 
@@ -220,23 +286,41 @@ private:
         m_data.back().returnArg.value = QVariant::fromValue(value);
     }
 
-    void fillLogData(LogData &) { }
-
-    template <typename T, typename... Ts>
-    void fillLogData(LogData &data, T param, Ts... params)
+    static Arg toArg(const Arg &arg) { return arg; }
+    template <typename T>
+    static Arg toArg(const T &param)
     {
         if constexpr (std::derived_from<T, LoggerArgBase>)
-            data.params.push_back(
-                {param.argName, valueToString(param.value, true), qMetaTypeId<decltype(param.value)>()});
+            return {QString::fromLatin1(param.argName), valueToString(param.value, true),
+                    qMetaTypeId<decltype(param.value)>()};
         else
-            data.params.push_back({"", valueToString(param, true), qMetaTypeId<T>()});
+            return {QString(), valueToString(param, true), qMetaTypeId<T>()};
+    }
 
-        fillLogData(data, params...);
+    template <typename T>
+    static auto deferArg(T &&param)
+    {
+        using Type = std::remove_cvref_t<T>;
+        if constexpr (std::derived_from<Type, LoggerArgBase>) {
+            if constexpr (IsPlainValue<decltype(param.value)>)
+                return Type(std::forward<T>(param));
+            else
+                return toArg(param);
+        } else if constexpr (IsPlainValue<Type>) {
+            return Type(std::forward<T>(param));
+        } else {
+            return toArg(param);
+        }
     }
 
+    int nameId(const QString &name);
     void addData(LogData &&data, bool merge);
+    void removeFirstRows(int count);
 
-    std::vector<LogData> m_data;
+    std::deque<LogData> m_data;
+    QStringList m_names;
+    QHash<QString, int> m_nameIds;
+    int m_limit = 0;
 };
 
 /**
@@ -248,40 +332,45 @@ private:
 class LoggerObject
 {
 public:
-    explicit LoggerObject(QString location, bool /*unused*/)
-        : LoggerObject()
-    {
-        if (!m_canLog)
-            return;
-
-        // When we're running a script, we ideally want to show some kind of feedback.
-        // As our scripts currently have to run on the GUI thread, the GUI is blocked.
-        // So we need to update the progress bar to show that the script is still running.
-        //
-        // We're doing this here, as logging happens quite often in pretty much all scripts.
-        // This has nothing to do with logging itself, but is just a good place to do it.
-        ScriptDialogItem::updateProgress();
-
-        if (m_model)
-            m_model->logData(location);
-        log(std::move(location));
-    }
-
-    template <typename... Ts>
-    explicit LoggerObject(QString location, bool merge, Ts... params)
-        : LoggerObject()
+    /**
+     * The parameters are returned as a tuple by `params`, which is only called if the call is recorded. Nested API
+     * calls, or calls done without history and trace logs, won't evaluate nor format them.
+     */
+    template <typename ParamsFunction>
+    explicit LoggerObject(const QString &location, bool merge, ParamsFunction &&params)
+        : LoggerObject(location)
     {
         if (!m_canLog)
             return;
 
-        if (m_model)
-            m_model->logData(location, merge, params...);
-
-        QStringList paramList;
-        (paramList.push_back(valueToString(params)), ...);
-
-        QString result = location + " - " + paramList.join(", ");
-        log(std::move(result));
+        using Params = std::invoke_result_t<ParamsFunction>;
+        if constexpr (std::tuple_size_v<Params> == 0) {
+            // When we're running a script, we ideally want to show some kind of feedback.
+            // As our scripts currently have to run on the GUI thread, the GUI is blocked.
+            // So we need to update the progress bar to show that the script is still running.
+            //
+            // We're doing this here, as logging happens quite often in pretty much all scripts.
+            // This has nothing to do with logging itself, but is just a good place to do it.
+            ScriptDialogItem::updateProgress();
+
+            if (m_model)
+                m_model->logData(location, merge, Params {});
+            if (spdlog::should_log(spdlog::level::trace))
+                spdlog::trace(location);
+        } else if (m_model || spdlog::should_log(spdlog::level::trace)) {
+            auto paramValues = params();
+            if (spdlog::should_log(spdlog::level::trace)) {
+                const QStringList paramList = std::apply(
+                    [](const auto &...param) {
+                        return QStringList {valueToString(param)...};
+                    },
+                    paramValues);
+                spdlog::trace(location + " - " + paramList.join(", "));
+            }
+            if (m_model)
+                m_model->logData(location, merge, std::move(paramValues));
+        }
+        m_canLog = false;
     }
 
     ~LoggerObject();
@@ -297,11 +386,12 @@ private:
     friend HistoryModel;
     friend LoggerDisabler;
 
-    LoggerObject();
-    void log(QString &&string);
+    explicit LoggerObject(const QString &location);
 
     inline static bool m_canLog = true;
     bool m_firstLogger = false;
+    // All API calls are profiled, even the nested ones which are not logged
+    Profiler::Scope m_profilerScope;
 
     inline static HistoryModel *m_model = nullptr;
 };
@@ -0,0 +1,329 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "profiler.h"
+#include "utils/log.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QTextStream>
+#include <QThread>
+#include <algorithm>
+#include <vector>
+
+namespace Core {
+
+// Maximum number of events kept for the trace, the statistics are still computed past this limit
+static constexpr size_t MaxTraceEvents = 1'000'000;
+
+static constexpr const char *CategoryNames[Profiler::CategoryCount] = {"api", "tree-sitter", "lsp", "text-editing"};
+
+namespace {
+
+struct Frame
+{
+    int nameId;
+    Profiler::Category category;
+    qint64 start;
+    qint64 children = 0;
+    std::array<qint64, Profiler::CategoryCount> categories = {};
+};
+
+struct Event
+{
+    int nameId;
+    Profiler::Category category;
+    qint64 start;
+    qint64 duration;
+};
+
+struct ProfilerData
+{
+    QElapsedTimer timer;
+    // Names are interned, so events only store an index
+    QHash<QString, int> nameIds;
+    std::vector<Profiler::Stats> stats;
+    std::vector<bool> isTextEditing;
+    std::vector<Frame> stack;
+    std::vector<Event> events;
+    qint64 droppedEvents = 0;
+
+    int nameId(const QString &name)
+    {
+        auto it = nameIds.constFind(name);
+        if (it != nameIds.cend())
+            return it.value();
+        const int id = static_cast<int>(stats.size());
+        nameIds.insert(name, id);
+        stats.push_back({.name = name});
+        isTextEditing.push_back(name.startsWith(QLatin1String("TextDocument::")));
+        return id;
+    }
+};
+
+} // namespace
+
+static ProfilerData &profilerData()
+{
+    static ProfilerData data;
+    return data;
+}
+
+static bool isGuiThread()
+{
+    return QCoreApplication::instance() && QThread::currentThread() == QCoreApplication::instance()->thread();
+}
+
+Profiler::Scope::Scope(Category category)
+    : m_active(m_enabled && isGuiThread())
+{
+    if (m_active)
+        begin(QString::fromLatin1(CategoryNames[category]), category);
+}
+
+Profiler::Scope::Scope(const QString &name, Category category)
+    : m_active(m_enabled && isGuiThread())
+{
+    if (m_active)
+        begin(name, category);
+}
+
+Profiler::Scope::~Scope()
+{
+    if (m_active)
+        end();
+}
+
+void Profiler::setEnabled(bool enabled)
+{
+    if (enabled && !profilerData().timer.isValid())
+        profilerData().timer.start();
+    m_enabled = enabled;
+}
+
+void Profiler::clear()
+{
+    auto &data = profilerData();
+    data.nameIds.clear();
+    data.stats.clear();
+    data.isTextEditing.clear();
+    data.stack.clear();
+    data.events.clear();
+    data.droppedEvents = 0;
+    data.timer.restart();
+}
+
+QList<Profiler::Stats> Profiler::stats()
+{
+    QList<Stats> result;
+    for (const auto &apiStats : profilerData().stats) {
+        if (apiStats.count > 0)
+            result.push_back(apiStats);
+    }
+    std::ranges::sort(result, [](const Stats &lhs, const Stats &rhs) {
+        return lhs.total > rhs.total;
+    });
+    return result;
+}
+
+void Profiler::begin(const QString &name, Category category)
+{
+    auto &data = profilerData();
+    data.stack.push_back({.nameId = data.nameId(name), .category = category, .start = data.timer.nsecsElapsed()});
+}
+
+void Profiler::end()
+{
+    auto &data = profilerData();
+    // The profiler may have been cleared in the middle of a call
+    if (data.stack.empty())
+        return;
+
+    const Frame frame = data.stack.back();
+    data.stack.pop_back();
+    const qint64 duration = data.timer.nsecsElapsed() - frame.start;
+
+    // Time spent in each category by this frame, including its children
+    auto categories = frame.categories;
+    if (frame.category == Api) {
+        if (data.isTextEditing[frame.nameId])
+            categories[TextEditing] = duration - categories[TreeSitter] - categories[Lsp];
+        auto &apiStats = data.stats[frame.nameId];
+        ++apiStats.count;
+        apiStats.total += duration;
+        apiStats.self += duration - frame.children;
+        for (int i = 0; i < CategoryCount; ++i)
+            apiStats.categories[i] += categories[i];
+    } else {
+        categories = {};
+        categories[frame.category] = duration;
+    }
+
+    if (!data.stack.empty()) {
+        auto &parent = data.stack.back();
+        parent.children += duration;
+        for (int i = 0; i < CategoryCount; ++i)
+            parent.categories[i] += categories[i];
+    }
+
+    if (data.events.size() < MaxTraceEvents)
+        data.events.push_back({frame.nameId, frame.category, frame.start, duration});
+    else
+        ++data.droppedEvents;
+}
+
+static QString escapeJson(QString text)
+{
+    text.replace('\\', QLatin1String("\\\\"));
+    text.replace('"', QLatin1String("\\\""));
+    return text;
+}
+
+/**
+ * Writes the profiling data as a Chrome trace (json object format).
+ * The statistics per API call are stored in the `summary` member, durations are in milliseconds.
+ */
+bool Profiler::writeTrace(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        spdlog::error("{}: Can't write the profile in {}", FUNCTION_NAME, fileName);
+        return false;
+    }
+
+    const auto &data = profilerData();
+    auto milliseconds = [](qint64 nsecs) {
+        return QString::number(static_cast<double>(nsecs) / 1e6, 'f', 3);
+    };
+    auto microseconds = [](qint64 nsecs) {
+        return QString::number(static_cast<double>(nsecs) / 1e3, 'f', 3);
+    };
+
+    QTextStream stream(&file);
+    stream << "{\n\"displayTimeUnit\": \"ms\",\n\"traceEvents\": [\n";
+    bool first = true;
+    for (const auto &event : data.events) {
+        stream << (first ? "" : ",\n") << R"({"name":")" << escapeJson(data.stats[event.nameId].name)
+               << R"(","cat":")" << CategoryNames[event.category] << R"(","ph":"X","pid":1,"tid":1,"ts":)"
+               << microseconds(event.start) << ",\"dur\":" << microseconds(event.duration) << '}';
+        first = false;
+    }
+    stream << "\n],\n\"droppedEvents\": " << data.droppedEvents << ",\n\"summary\": [\n";
+    first = true;
+    const auto allStats = stats();
+    for (const auto &apiStats : allStats) {
+        stream << (first ? "" : ",\n") << R"({"name":")" << escapeJson(apiStats.name) << R"(","count":)"
+               << apiStats.count << ",\"total\":" << milliseconds(apiStats.total)
+               << ",\"self\":" << milliseconds(apiStats.self)
+               << ",\"treeSitter\":" << milliseconds(apiStats.categories[TreeSitter])
+               << ",\"lsp\":" << milliseconds(apiStats.categories[Lsp])
+               << ",\"textEditing\":" << milliseconds(apiStats.categories[TextEditing]) << '}';
+        first = false;
+    }
+    stream << "\n]\n}\n";
+    stream.flush();
+
+    if (data.droppedEvents > 0)
+        spdlog::warn("{}: {} events not stored in the trace", FUNCTION_NAME, data.droppedEvents);
+    spdlog::info("{}: Profile written in {}", FUNCTION_NAME, fileName);
+    return stream.status() == QTextStream::Ok;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// ProfilerModel
+///////////////////////////////////////////////////////////////////////////////
+ProfilerModel::ProfilerModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+ProfilerModel::~ProfilerModel() = default;
+
+int ProfilerModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return static_cast<int>(m_stats.size());
+}
+
+int ProfilerModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent)
+    return ColumnCount;
+}
+
+QVariant ProfilerModel::data(const QModelIndex &index, int role) const
+{
+    Q_ASSERT(checkIndex(index, CheckIndexOption::IndexIsValid));
+
+    if (role != Qt::DisplayRole && role != Qt::UserRole)
+        return {};
+
+    const auto &stats = m_stats.at(index.row());
+    auto duration = [role](qint64 nsecs) -> QVariant {
+        // Qt::UserRole is used for sorting
+        if (role == Qt::UserRole)
+            return nsecs;
+        return QString::number(static_cast<double>(nsecs) / 1e6, 'f', 2);
+    };
+
+    switch (index.column()) {
+    case NameCol:
+        return stats.name;
+    case CountCol:
+        return stats.count;
+    case TotalCol:
+        return duration(stats.total);
+    case SelfCol:
+        return duration(stats.self);
+    case TreeSitterCol:
+        return duration(stats.categories[Profiler::TreeSitter]);
+    case LspCol:
+        return duration(stats.categories[Profiler::Lsp]);
+    case TextEditingCol:
+        return duration(stats.categories[Profiler::TextEditing]);
+    }
+    return {};
+}
+
+QVariant ProfilerModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Vertical || role != Qt::DisplayRole)
+        return {};
+
+    switch (section) {
+    case NameCol:
+        return tr("API name");
+    case CountCol:
+        return tr("Calls");
+    case TotalCol:
+        return tr("Total (ms)");
+    case SelfCol:
+        return tr("Self (ms)");
+    case TreeSitterCol:
+        return tr("Tree-sitter (ms)");
+    case LspCol:
+        return tr("LSP (ms)");
+    case TextEditingCol:
+        return tr("Text editing (ms)");
+    }
+    return {};
+}
+
+void ProfilerModel::refresh()
+{
+    beginResetModel();
+    m_stats = Profiler::stats();
+    endResetModel();
+}
+
+} // namespace Core
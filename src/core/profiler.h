@@ -0,0 +1,99 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QList>
+#include <QString>
+#include <array>
+
+namespace Core {
+
+/**
+ * @brief Opt-in profiler for the script API
+ *
+ * When enabled, each API call (through the LOG macros) is timed, as well as the time spent in tree-sitter and in the
+ * LSP server. Time spent in nested TextDocument API calls is accounted as text editing. Only calls done on the GUI
+ * thread are profiled.
+ *
+ * The results are available as statistics per API, or as a Chrome trace (also readable by speedscope or perfetto).
+ */
+class Profiler
+{
+public:
+    enum Category { Api, TreeSitter, Lsp, TextEditing, CategoryCount };
+
+    struct Stats
+    {
+        QString name;
+        qint64 count = 0;
+        // All durations are in nanoseconds
+        qint64 total = 0;
+        qint64 self = 0;
+        std::array<qint64, CategoryCount> categories = {};
+    };
+
+    /**
+     * @brief RAII class measuring a scope, if the profiler is enabled
+     * Do not use this class directly for API calls, they are already measured by the LOG macros.
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(Category category);
+        Scope(const QString &name, Category category);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        bool m_active = false;
+    };
+
+    static bool isEnabled() { return m_enabled; }
+    static void setEnabled(bool enabled);
+    static void clear();
+
+    // Statistics per API call, sorted by total time
+    static QList<Stats> stats();
+    static bool writeTrace(const QString &fileName);
+
+private:
+    static void begin(const QString &name, Category category);
+    static void end();
+
+    inline static bool m_enabled = false;
+};
+
+class ProfilerModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Columns { NameCol = 0, CountCol, TotalCol, SelfCol, TreeSitterCol, LspCol, TextEditingCol, ColumnCount };
+
+    explicit ProfilerModel(QObject *parent = nullptr);
+    ~ProfilerModel() override;
+
+    int rowCount(const QModelIndex &parent = {}) const override;
+    int columnCount(const QModelIndex &parent = {}) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // Update the model with the current statistics of the profiler
+    void refresh();
+
+private:
+    QList<Profiler::Stats> m_stats;
+};
+
+} // namespace Core
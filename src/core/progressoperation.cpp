@@ -0,0 +1,76 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "progressoperation.h"
+#include "scriptdialogitem.h"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <cmath>
+
+namespace Core {
+
+static bool isGuiThread()
+{
+    return QCoreApplication::instance() && QThread::currentThread() == QCoreApplication::instance()->thread();
+}
+
+ProgressOperation::ProgressOperation(QString title, QString unit)
+    : m_title(std::move(title))
+    , m_unit(std::move(unit))
+    , m_registered(isGuiThread())
+{
+    m_timer.start();
+    if (m_registered)
+        m_operations.push_back(this);
+}
+
+ProgressOperation::~ProgressOperation()
+{
+    if (m_registered)
+        m_operations.removeOne(this);
+}
+
+bool ProgressOperation::advance(qint64 done, qint64 total)
+{
+    ++m_count;
+    m_done = done;
+    m_total = total;
+    if (m_registered)
+        ScriptDialogItem::updateProgress();
+    return !isCancelled();
+}
+
+QString ProgressOperation::statusText() const
+{
+    QString text = QStringLiteral("%1: %2 %3").arg(m_title).arg(m_count).arg(m_unit);
+
+    const double seconds = static_cast<double>(m_timer.elapsed()) / 1000;
+    if (seconds > 0)
+        text += QStringLiteral(" (%1/s)").arg(std::llround(static_cast<double>(m_count) / seconds));
+    if (m_done > 0 && m_done < m_total) {
+        const double remaining = seconds * static_cast<double>(m_total - m_done) / static_cast<double>(m_done);
+        text += QStringLiteral(", ETA %1s").arg(std::ceil(remaining));
+    }
+    return text;
+}
+
+ProgressOperation *ProgressOperation::current()
+{
+    return m_operations.isEmpty() ? nullptr : m_operations.last();
+}
+
+void ProgressOperation::cancelAll()
+{
+    for (auto *operation : std::as_const(m_operations))
+        operation->cancel();
+}
+
+} // namespace Core
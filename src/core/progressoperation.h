@@ -0,0 +1,62 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+#include <atomic>
+
+namespace Core {
+
+/**
+ * A long-running operation (like a query), reporting its progress and which can be cancelled.
+ *
+ * Operations created on the GUI thread are registered while they exist: the script progress dialog shows the status
+ * of the current one (number of items processed, rate and ETA) and can cancel it. Reporting is cheap, the GUI is only
+ * updated at a limited rate by ScriptDialogItem::updateProgress.
+ */
+class ProgressOperation
+{
+public:
+    explicit ProgressOperation(QString title, QString unit = QStringLiteral("items"));
+    ~ProgressOperation();
+
+    ProgressOperation(const ProgressOperation &) = delete;
+    ProgressOperation &operator=(const ProgressOperation &) = delete;
+
+    // One more item processed. `done` and `total` estimate the work done so far, they are used to compute the ETA and
+    // can be 0 if unknown. Returns false if the operation has been cancelled.
+    bool advance(qint64 done = 0, qint64 total = 0);
+
+    void cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+    QString statusText() const;
+
+    // The last operation started on the GUI thread, if any
+    static ProgressOperation *current();
+    static void cancelAll();
+
+private:
+    QString m_title;
+    QString m_unit;
+    qint64 m_count = 0;
+    qint64 m_done = 0;
+    qint64 m_total = 0;
+    QElapsedTimer m_timer;
+    std::atomic_bool m_cancelled = false;
+    bool m_registered = false;
+
+    static inline QList<ProgressOperation *> m_operations = {};
+};
+
+} // namespace Core
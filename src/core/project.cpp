@@ -10,6 +10,7 @@
 
 #include "project.h"
 #include "cppdocument.h"
+#include "documentsnapshot.h"
 #include "imagedocument.h"
 #include "jsondocument.h"
 #include "logger.h"
@@ -22,14 +23,21 @@
 #include "settings.h"
 #include "slintdocument.h"
 #include "textdocument.h"
+#include "textdocument_p.h"
 #include "utils/log.h"
+#include "utils/string_helper.h"
 
 #include <QDir>
 #include <QDirIterator>
 #include <QFileInfo>
 #include <QMetaEnum>
 #include <QProcess>
+#include <QSaveFile>
 #include <QStandardPaths>
+#include <QStringDecoder>
+#include <QtConcurrent>
+#include <QtQml/private/qjsvalue_p.h>
+#include <QtQml/private/qv4engine_p.h>
 #include <algorithm>
 #include <kdalgorithms.h>
 #include <map>
@@ -193,13 +201,17 @@ QStringList Project::allFilesWithExtensions(const QStringList &extensions, PathT
     return result;
 }
 
-static Document *createDocument(const QString &suffix)
+static const std::map<std::string, Document::Type> &mimeTypes()
 {
     static const auto mimeTypes =
         Settings::instance()->value<std::map<std::string, Document::Type>>(Settings::MimeTypes);
+    return mimeTypes;
+}
 
-    auto it = mimeTypes.find(suffix.toStdString());
-    if (it == mimeTypes.end()) {
+static Document *createDocument(const QString &suffix)
+{
+    auto it = mimeTypes().find(suffix.toStdString());
+    if (it == mimeTypes().end()) {
         // No mime found, so, just open it as text
         return new TextDocument();
     }
@@ -230,6 +242,55 @@ static Document *createDocument(const QString &suffix)
     return nullptr;
 }
 
+void Project::initializeUndo(TextDocument *document)
+{
+    if (!Settings::instance()->hasUndo()) {
+        document->setUndoMemoryLimit(0);
+        return;
+    }
+
+    constexpr qsizetype MB = 1024 * 1024;
+    const auto settings = DEFAULT_VALUE(UndoSettings, Undo);
+    document->setUndoMemoryLimit(settings.documentLimit < 0 ? -1 : settings.documentLimit * MB);
+    m_undoMemoryLimit = settings.projectLimit < 0 ? -1 : settings.projectLimit * MB;
+    connect(document, &TextDocument::undoMemoryUsageChanged, this, &Project::updateUndoMemoryUsage);
+}
+
+// Compacts the undo history of the largest documents, until the memory used by all documents is below the limit.
+// The usage changes while a document is being edited, so the compaction is done later, once the edit is finished.
+void Project::updateUndoMemoryUsage(qsizetype usage, qsizetype oldUsage)
+{
+    m_undoMemoryUsage += usage - oldUsage;
+    if (m_isCompactingUndo || m_isUndoCompactionPending || m_undoMemoryLimit < 0
+        || m_undoMemoryUsage <= m_undoMemoryLimit)
+        return;
+
+    m_isUndoCompactionPending = true;
+    QMetaObject::invokeMethod(this, &Project::compactUndoHistories, Qt::QueuedConnection);
+}
+
+void Project::compactUndoHistories()
+{
+    m_isUndoCompactionPending = false;
+    if (m_undoMemoryLimit < 0 || m_undoMemoryUsage <= m_undoMemoryLimit)
+        return;
+
+    QList<TextDocument *> documents;
+    for (auto document : std::as_const(m_documents)) {
+        if (auto textDocument = qobject_cast<TextDocument *>(document))
+            documents.push_back(textDocument);
+    }
+    std::ranges::sort(documents, std::greater {}, &TextDocument::undoMemoryUsage);
+
+    m_isCompactingUndo = true;
+    for (auto document : std::as_const(documents)) {
+        if (m_undoMemoryUsage <= m_undoMemoryLimit)
+            break;
+        document->compactUndoHistory();
+    }
+    m_isCompactingUndo = false;
+}
+
 Lsp::Client *Project::getClient(Document::Type type)
 {
     // Check if we use LSP
@@ -284,6 +345,8 @@ Document *Project::getDocument(QString fileName, bool moveToBack)
         if (doc) {
             if (auto codeDocument = qobject_cast<CodeDocument *>(doc))
                 codeDocument->setLspClient(getClient(doc->type()));
+            if (auto textDocument = qobject_cast<TextDocument *>(doc))
+                initializeUndo(textDocument);
             doc->setParent(this);
             doc->load(fileName);
             m_documents.push_back(doc);
@@ -481,4 +544,321 @@ bool Project::isFindInFilesAvailable() const
     }
 }
 
+struct ReplaceInFileResult
+{
+    QString fileName;
+    int count = 0;
+    QString error;
+};
+
+// Replace all occurrences in a file on disk, without creating a TextDocument.
+// The file is handled the same way TextDocument::doLoad/doSave do: UTF-8 content, optional UTF-8 BOM and line
+// endings (LF or CRLF, detected from the first line) are kept as they were.
+static ReplaceInFileResult replaceInFile(const QString &fileName, const QRegularExpression &regexp,
+                                         const QString &after, bool usesRegExp, bool preserveCase)
+{
+    ReplaceInFileResult result {fileName, 0, {}};
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.error = file.errorString();
+        return result;
+    }
+    QByteArray data = file.readAll();
+    file.close();
+
+    // Skip binary files, we don't want to corrupt them
+    if (data.contains('\0'))
+        return result;
+
+    const bool utf8Bom = data.startsWith("\xef\xbb\xbf");
+    const qsizetype newLinePos = data.indexOf('\n');
+    const bool crlf = newLinePos > 0 && data.at(newLinePos - 1) == '\r';
+
+    QStringDecoder decoder(QStringDecoder::Utf8);
+    QString text = decoder(QByteArrayView(data).sliced(utf8Bom ? 3 : 0));
+    if (decoder.hasError()) {
+        result.error = "not a valid UTF-8 file";
+        return result;
+    }
+    text.replace("\r\n", "\n");
+
+    QString newText;
+    qsizetype lastEnd = 0;
+    auto it = regexp.globalMatch(text);
+    while (it.hasNext()) {
+        const auto match = it.next();
+        if (match.capturedLength() == 0)
+            continue;
+        newText += QStringView(text).sliced(lastEnd, match.capturedStart() - lastEnd);
+        if (usesRegExp)
+            newText += Utils::expandRegExpReplacement(after, match.capturedTexts());
+        else if (preserveCase)
+            newText += Utils::matchCaseReplacement(match.captured(), after);
+        else
+            newText += after;
+        lastEnd = match.capturedEnd();
+        ++result.count;
+    }
+    if (result.count == 0)
+        return result;
+    newText += QStringView(text).sliced(lastEnd);
+
+    if (crlf)
+        newText.replace('\n', "\r\n");
+
+    QSaveFile saveFile(fileName);
+    if (!saveFile.open(QIODevice::WriteOnly)) {
+        result.error = saveFile.errorString();
+        return result;
+    }
+    if (utf8Bom)
+        saveFile.write("\xef\xbb\xbf", 3);
+    saveFile.write(newText.toUtf8());
+    if (!saveFile.commit())
+        result.error = saveFile.errorString();
+    return result;
+}
+
+// Lists the files to change in `path` recursively. Like allFiles, hidden entries (.git...) are skipped, and so are
+// build directories (containing a CMakeCache.txt), changing generated files would be pointless.
+static void collectFilesToReplace(const QString &path, const QStringList &fileFilter, QStringList &files)
+{
+    QDir dir(path);
+    if (dir.exists("CMakeCache.txt"))
+        return;
+    const auto fileInfos = dir.entryInfoList(fileFilter, QDir::Files, QDir::Name);
+    for (const auto &fi : fileInfos)
+        files.push_back(fi.absoluteFilePath());
+    const auto dirInfos = dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks, QDir::Name);
+    for (const auto &fi : dirInfos)
+        collectFilesToReplace(fi.absoluteFilePath(), fileFilter, files);
+}
+
+// clang-format off
+/*!
+ * \qmlmethod array<object> Project::replaceInFiles(string pattern, string replacement, FindFlags options = TextDocument.NoFindFlags, array<string> fileFilter = [])
+ * Replaces all occurrences of `pattern` with `replacement` in all files of the current project. Options are the same
+ * as for `TextDocument::replaceAll`:
+ *
+ * - `TextDocument.FindCaseSensitively`: match case
+ * - `TextDocument.FindWholeWords`: match only complete words
+ * - `TextDocument.FindRegexp`: use a regexp, captures can be used in the replacement text
+ * - `TextDocument.PreserveCase`: preserve case when replacing
+ *
+ * `fileFilter` is a list of wildcard patterns (like `*.cpp`) used to filter the file names, all files are handled if
+ * it's empty.
+ *
+ * Files that are not opened are searched and rewritten in parallel, directly on the disk, keeping their encoding, line
+ * endings and BOM. Documents already opened in the project are changed using `TextDocument::replaceAll`, and are
+ * not saved.
+ *
+ * Returns a list of results with the file name and the number of replacements ("file", "count") for each file
+ * changed. If a file can't be changed, the result also contains an "error" string.
+ *
+ * ```js
+ * let results = Project.replaceInFiles("CMyDialog", "MyDialog", TextDocument.FindWholeWords, ["*.cpp", "*.h"]);
+ * for (let result of results)
+ *     Message.log(result.file + ": " + result.count);
+ * ```
+ */
+// clang-format on
+QVariantList Project::replaceInFiles(const QString &pattern, const QString &replacement,
+                                     TextDocument::FindFlags options, const QStringList &fileFilter)
+{
+    LOG(pattern, replacement, options, fileFilter);
+
+    QVariantList result;
+    if (m_root.isEmpty() || pattern.isEmpty())
+        return result;
+
+    const bool usesRegExp = options & TextDocument::FindRegexp;
+    const bool preserveCase = options & TextDocument::PreserveCase;
+    QRegularExpression regexp = Utils::createRegularExpression(pattern, options, usesRegExp);
+    if (options & TextDocument::FindWholeWords)
+        regexp.setPattern("\\b(?:" + regexp.pattern() + ")\\b");
+    if (!regexp.isValid()) {
+        spdlog::error("{}: invalid pattern {} - {}", FUNCTION_NAME, pattern, regexp.errorString());
+        return result;
+    }
+
+    auto addResult = [&result](const QString &fileName, int count, const QString &error = {}) {
+        QVariantMap fileResult;
+        fileResult.insert("file", fileName);
+        fileResult.insert("count", count);
+        if (!error.isEmpty())
+            fileResult.insert("error", error);
+        result.append(fileResult);
+    };
+
+    QStringList projectFiles;
+    collectFilesToReplace(m_root, fileFilter, projectFiles);
+
+    QStringList files;
+    QList<Document *> reloadDocuments;
+    for (const auto &fileName : std::as_const(projectFiles)) {
+        auto document = kdalgorithms::find_if(m_documents, [&fileName](Document *document) {
+            return document->fileName() == fileName;
+        });
+        if (!document) {
+            files.push_back(fileName);
+            continue;
+        }
+
+        // Opened documents are changed using the normal edit path
+        if (auto textDocument = qobject_cast<TextDocument *>(*document)) {
+            if (const int count = textDocument->replaceAll(pattern, replacement, options))
+                addResult(fileName, count);
+        } else if ((*document)->hasChanged()) {
+            spdlog::warn("{}: {} has unsaved changes and can't be changed", FUNCTION_NAME, fileName);
+            addResult(fileName, 0, "document has unsaved changes");
+        } else {
+            files.push_back(fileName);
+            reloadDocuments.push_back(*document);
+        }
+    }
+
+    const auto fileResults =
+        QtConcurrent::blockingMapped(files, [&regexp, &replacement, usesRegExp, preserveCase](const QString &fileName) {
+            return replaceInFile(fileName, regexp, replacement, usesRegExp, preserveCase);
+        });
+
+    for (const auto &fileResult : fileResults) {
+        if (fileResult.count == 0 && fileResult.error.isEmpty())
+            continue;
+        if (!fileResult.error.isEmpty())
+            spdlog::warn("{}: can't replace in {} - {}", FUNCTION_NAME, fileResult.fileName, fileResult.error);
+        addResult(fileResult.fileName, fileResult.count, fileResult.error);
+    }
+
+    for (auto document : std::as_const(reloadDocuments)) {
+        if (document->hasChangedOnDisk())
+            document->reload();
+    }
+
+    return result;
+}
+
+// clang-format off
+/*!
+ * \qmlmethod array<object> Project::analyzeFiles(array<string> files, var queryOrCallback)
+ * Analyzes all `files` in parallel, without opening them in the project. Files are relative to the project root, or
+ * absolute. Returns the aggregated results.
+ *
+ * Each file is loaded and parsed on a worker thread, as a [DocumentSnapshot](documentsnapshot.md). Opened documents
+ * are analyzed with their current text. `queryOrCallback` can be either:
+ *
+ * - a Tree-sitter query: the query is run on a worker thread for each file. The result is a list of objects, one per
+ *   file with at least one match, with a `file` and a `matches` property (see `DocumentSnapshot::query`).
+ * - a function: the function is called on the main thread for each file, with the snapshot as argument. The result
+ *   is a list of objects with a `file` and a `result` property, for each call not returning `undefined`.
+ *
+ * Files that can't be read are returned with an `error` property.
+ *
+ * ```js
+ * let files = Project.allFilesWithExtensions(["h", "cpp"]);
+ * let results = Project.analyzeFiles(files, "(class_specifier name: (_) @name)");
+ * for (let result of results)
+ *     Message.log(result.file + ": " + result.matches.length + " classes");
+ *
+ * let symbols = Project.analyzeFiles(files, function(snapshot) { return snapshot.symbols.length; });
+ * ```
+ */
+// clang-format on
+QVariantList Project::analyzeFiles(const QStringList &files, const QJSValue &queryOrCallback)
+{
+    LOG(files, queryOrCallback);
+
+    QVariantList result;
+    const bool isQuery = queryOrCallback.isString();
+    QJSEngine *engine = nullptr;
+    if (!isQuery) {
+        if (auto v4 = QJSValuePrivate::engine(&queryOrCallback); v4 && queryOrCallback.isCallable())
+            engine = v4->jsEngine();
+        if (!engine) {
+            spdlog::error("{}: the second argument must be a query or a function", FUNCTION_NAME);
+            return result;
+        }
+    }
+
+    // Everything depending on the project or the settings is done here, on the main thread
+    struct FileToAnalyze
+    {
+        QString fileName;
+        Document::Type type;
+        std::optional<QString> text;
+    };
+    QList<FileToAnalyze> filesToAnalyze;
+    filesToAnalyze.reserve(files.size());
+    const QDir rootDir(m_root);
+    for (const auto &file : files) {
+        const QString fileName = QDir::cleanPath(rootDir.absoluteFilePath(file));
+        auto it = mimeTypes().find(QFileInfo(fileName).suffix().toStdString());
+        FileToAnalyze fileToAnalyze {.fileName = fileName,
+                                     .type = it == mimeTypes().end() ? Document::Type::Text : it->second,
+                                     .text = std::nullopt};
+        auto document = kdalgorithms::find_if(m_documents, [&fileName](Document *document) {
+            return document->fileName() == fileName;
+        });
+        if (document && (*document)->hasChanged()) {
+            if (auto textDocument = qobject_cast<TextDocument *>(*document))
+                fileToAnalyze.text = textDocument->text();
+        }
+        filesToAnalyze.push_back(std::move(fileToAnalyze));
+    }
+    const auto excludedMacros = Settings::instance()->value<QStringList>(Settings::CppExcludedMacros);
+
+    auto createSnapshot = [&excludedMacros](const FileToAnalyze &file) {
+        if (file.text)
+            return DocumentSnapshot::fromText(file.fileName, *file.text, file.type, excludedMacros);
+        return DocumentSnapshot::fromFile(file.fileName, file.type, excludedMacros);
+    };
+    auto errorResult = [](const QString &fileName) {
+        return QVariantMap {{"file", fileName}, {"error", "can't read the file"}};
+    };
+
+    // Files are analyzed by batches, so the snapshots of all files are not kept in memory at the same time
+    static constexpr qsizetype BatchSize = 256;
+    for (qsizetype start = 0; start < filesToAnalyze.size(); start += BatchSize) {
+        const auto batch = filesToAnalyze.mid(start, BatchSize);
+
+        if (isQuery) {
+            const QString query = queryOrCallback.toString();
+            const auto fileResults =
+                QtConcurrent::blockingMapped(batch, [&createSnapshot, &errorResult, &query](const FileToAnalyze &file) {
+                    const auto snapshot = createSnapshot(file);
+                    if (!snapshot.isValid())
+                        return errorResult(file.fileName);
+                    const auto matches = snapshot.query(query);
+                    if (matches.isEmpty())
+                        return QVariantMap();
+                    return QVariantMap {{"file", file.fileName}, {"matches", matches}};
+                });
+            for (const auto &fileResult : fileResults) {
+                if (!fileResult.isEmpty())
+                    result.push_back(fileResult);
+            }
+            continue;
+        }
+
+        const auto snapshots = QtConcurrent::blockingMapped(batch, createSnapshot);
+        for (qsizetype i = 0; i < snapshots.size(); ++i) {
+            const auto &snapshot = snapshots.at(i);
+            if (!snapshot.isValid()) {
+                result.push_back(errorResult(batch.at(i).fileName));
+                continue;
+            }
+            const QJSValue value = queryOrCallback.call({engine->toScriptValue(snapshot)});
+            if (value.isError()) {
+                spdlog::error("{}: error in {} - {}", FUNCTION_NAME, snapshot.fileName(), value.toString());
+                return result;
+            }
+            if (!value.isUndefined())
+                result.push_back(QVariantMap {{"file", snapshot.fileName()}, {"result", value.toVariant()}});
+        }
+    }
+
+    return result;
+}
+
 } // namespace Core
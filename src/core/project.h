@@ -11,7 +11,9 @@
 #pragma once
 
 #include "document.h"
+#include "textdocument.h"
 
+#include <QJSValue>
 #include <QObject>
 #include <unordered_map>
 
@@ -55,6 +57,10 @@ public:
                                                    Core::Project::PathType type = RelativeToRoot);
     Q_INVOKABLE QVariantList findInFiles(const QString &pattern) const;
     Q_INVOKABLE bool isFindInFilesAvailable() const;
+    Q_INVOKABLE QVariantList replaceInFiles(const QString &pattern, const QString &replacement,
+                                            Core::TextDocument::FindFlags options = Core::TextDocument::NoFindFlags,
+                                            const QStringList &fileFilter = {});
+    Q_INVOKABLE QVariantList analyzeFiles(const QStringList &files, const QJSValue &queryOrCallback);
 
 public slots:
     Core::Document *get(const QString &fileName);
@@ -74,6 +80,9 @@ private:
 
     Core::Document *getDocument(QString fileName, bool moveToBack = false);
     Lsp::Client *getClient(Document::Type type);
+    void initializeUndo(TextDocument *document);
+    void updateUndoMemoryUsage(qsizetype usage, qsizetype oldUsage);
+    void compactUndoHistories();
 
 private:
     inline static Project *m_instance = nullptr;
@@ -82,6 +91,12 @@ private:
     QList<Document *> m_documents;
     Core::Document *m_current = nullptr;
     std::unordered_map<Core::Document::Type, Lsp::Client *> m_lspClients;
+
+    // Memory used by the undo history of all text documents, in bytes (-1 means no limit)
+    qsizetype m_undoMemoryUsage = 0;
+    qsizetype m_undoMemoryLimit = -1;
+    bool m_isCompactingUndo = false;
+    bool m_isUndoCompactionPending = false;
 };
 
 } // namespace Core
@@ -10,12 +10,15 @@
 
 #include "querymatch.h"
 #include "codedocument.h"
+#include "mark.h"
+#include "querymatch_p.h"
 #include "rangemark.h"
 #include "textdocument.h"
 #include "utils/log.h"
 
 #include <QJSEngine>
-#include <kdalgorithms.h>
+#include <QPlainTextEdit>
+#include <algorithm>
 #include <treesitter/query.h>
 
 namespace Core {
@@ -82,27 +85,102 @@ QString QueryCapture::toString() const
  * Return true if the `QueryMatch` is empty.
  */
 
+QueryMatchPrivate::QueryMatchPrivate(TextDocument *document, QStringList names)
+    : m_document(document)
+    , m_names(std::move(names))
+{
+    Q_ASSERT(document);
+    connect(document->textEdit()->document(), &QTextDocument::contentsChange, this, &QueryMatchPrivate::update);
+}
+
+void QueryMatchPrivate::update(int from, int charsRemoved, int charsAdded)
+{
+    for (auto &capture : m_captures) {
+        Mark::updateMark(capture.start, from, charsRemoved, charsAdded);
+        Mark::updateMark(capture.end, from, charsRemoved, charsAdded);
+        if (capture.start > capture.end)
+            std::swap(capture.start, capture.end);
+    }
+}
+
+RangeMark QueryMatchPrivate::range(int index)
+{
+    auto &capture = m_captures[index];
+    // Promote the capture to a RangeMark, which will be kept up-to-date even if the match is deleted
+    if (!capture.range.isValid() && m_document && capture.start >= 0 && capture.end >= 0)
+        capture.range = RangeMark(m_document, capture.start, capture.end);
+    return capture.range;
+}
+
+std::shared_ptr<QueryMatchPrivate> QueryMatch::createPrivate(TextDocument &document,
+                                                             const treesitter::QueryMatch &match)
+{
+    // Capture names are only computed once for all the matches of the query
+    QStringList names;
+    const auto captures = match.query()->captures();
+    names.reserve(captures.size());
+    for (const auto &capture : captures)
+        names.push_back(capture.name);
+    return std::make_shared<QueryMatchPrivate>(&document, std::move(names));
+}
+
 QueryMatch::QueryMatch(TextDocument &document, const treesitter::QueryMatch &match)
+    : QueryMatch(createPrivate(document, match), match)
+{
+}
+
+QueryMatch::QueryMatch(const std::shared_ptr<QueryMatchPrivate> &d, const treesitter::QueryMatch &match)
+    : d(d)
 {
     const auto captures = match.captures();
+    m_first = static_cast<int>(d->m_captures.size());
+    m_count = static_cast<int>(captures.size());
     for (const auto &capture : captures) {
-        const auto name = match.query()->captureAt(capture.id).name;
-
         const auto &node = capture.node;
-        const auto range = document.createRangeMark(node.startPosition(), node.endPosition());
-
-        m_captures.emplace_back(QueryCapture {.name = name, .range = range});
+        d->m_captures.push_back({.nameId = static_cast<int>(capture.id),
+                                 .start = static_cast<int>(node.startPosition()),
+                                 .end = static_cast<int>(node.endPosition()),
+                                 .range = {}});
     }
 }
 
-const QList<QueryCapture> &QueryMatch::captures() const
+QueryMatchList QueryMatch::fromMatches(TextDocument &document, const QList<treesitter::QueryMatch> &matches)
+{
+    if (matches.isEmpty())
+        return {};
+
+    auto d = createPrivate(document, matches.first());
+    QueryMatchList result;
+    result.reserve(matches.size());
+    for (const auto &match : matches)
+        result.push_back(QueryMatch(d, match));
+    return result;
+}
+
+int QueryMatch::nameId(const QString &name) const
+{
+    return d ? static_cast<int>(d->m_names.indexOf(name)) : -1;
+}
+
+bool QueryMatch::isInRange(int index, const Core::RangeMark &range) const
 {
-    return m_captures;
+    const auto &capture = d->m_captures.at(index);
+    return range.isValid() && range.document() == d->m_document && range.start() <= capture.start
+        && capture.end <= range.end();
+}
+
+QList<QueryCapture> QueryMatch::captures() const
+{
+    QList<QueryCapture> result;
+    result.reserve(m_count);
+    for (int i = m_first; i < m_first + m_count; ++i)
+        result.push_back(QueryCapture {.name = d->m_names.value(d->m_captures.at(i).nameId), .range = d->range(i)});
+    return result;
 }
 
 bool QueryMatch::isEmpty() const
 {
-    return m_captures.isEmpty();
+    return m_count == 0;
 }
 
 /*!
@@ -113,9 +191,10 @@ Core::RangeMarkList QueryMatch::getAll(const QString &name) const
 {
     Core::RangeMarkList result;
 
-    for (const auto &capture : m_captures) {
-        if (capture.name == name)
-            result.emplace_back(capture.range);
+    const int id = nameId(name);
+    for (int i = m_first; i < m_first + m_count; ++i) {
+        if (d->m_captures.at(i).nameId == id)
+            result.emplace_back(d->range(i));
     }
 
     return result;
@@ -127,13 +206,15 @@ Core::RangeMarkList QueryMatch::getAll(const QString &name) const
  */
 Core::RangeMarkList QueryMatch::getAllInRange(const QString &name, const Core::RangeMark &range) const
 {
-    auto captureMatch = [&name, &range](const QueryCapture &capture) {
-        return capture.name == name && range.contains(capture.range);
-    };
-    auto toRange = [](const QueryCapture &capture) {
-        return capture.range;
-    };
-    return kdalgorithms::filtered_transformed(m_captures, toRange, captureMatch);
+    Core::RangeMarkList result;
+
+    const int id = nameId(name);
+    for (int i = m_first; i < m_first + m_count; ++i) {
+        if (d->m_captures.at(i).nameId == id && isInRange(i, range))
+            result.emplace_back(d->range(i));
+    }
+
+    return result;
 }
 
 /*!
@@ -154,9 +235,10 @@ Core::RangeMarkList QueryMatch::getAllInRange(const QString &name, const Core::R
  */
 RangeMark QueryMatch::get(const QString &name) const
 {
-    for (const auto &capture : m_captures) {
-        if (capture.name == name)
-            return capture.range;
+    const int id = nameId(name);
+    for (int i = m_first; i < m_first + m_count; ++i) {
+        if (d->m_captures.at(i).nameId == id)
+            return d->range(i);
     }
 
     return RangeMark();
@@ -168,12 +250,12 @@ RangeMark QueryMatch::get(const QString &name) const
  */
 Core::RangeMark QueryMatch::getInRange(const QString &name, const Core::RangeMark &range) const
 {
-    auto captureMatch = [&name, &range](const QueryCapture &capture) {
-        return capture.name == name && range.contains(capture.range);
-    };
-    auto result = kdalgorithms::find_if(m_captures, captureMatch);
-    if (result)
-        return result->range;
+    const int id = nameId(name);
+    for (int i = m_first; i < m_first + m_count; ++i) {
+        if (d->m_captures.at(i).nameId == id && isInRange(i, range))
+            return d->range(i);
+    }
+
     return {};
 }
 
@@ -183,12 +265,21 @@ Core::RangeMark QueryMatch::getInRange(const QString &name, const Core::RangeMar
  */
 RangeMark QueryMatch::getAllJoined(const QString &name) const
 {
-    auto ranges = getAll(name);
+    const int id = nameId(name);
+    int start = -1;
+    int end = -1;
+    for (int i = m_first; i < m_first + m_count; ++i) {
+        const auto &capture = d->m_captures.at(i);
+        if (capture.nameId != id)
+            continue;
+        start = start == -1 ? capture.start : std::min(start, capture.start);
+        end = std::max(end, capture.end);
+    }
 
-    if (ranges.isEmpty())
+    if (start == -1 || !d->m_document)
         return RangeMark();
 
-    return kdalgorithms::accumulate(ranges, &RangeMark::join, ranges.at(0));
+    return RangeMark(d->m_document, start, end);
 }
 
 /**
@@ -232,7 +323,7 @@ Core::QueryMatchList QueryMatch::queryIn(const QString &capture, const QString &
 
 QString QueryMatch::toString() const
 {
-    return QString("QueryMatch{%1}").arg(m_captures.size());
+    return QString("QueryMatch{%1}").arg(m_count);
 }
 
 } // namespace Core
@@ -13,6 +13,7 @@
 #include "rangemark.h"
 
 #include <QObject>
+#include <memory>
 
 namespace treesitter {
 class QueryMatch;
@@ -21,6 +22,7 @@ class QueryMatch;
 namespace Core {
 
 class TextDocument;
+class QueryMatchPrivate;
 
 class QueryCapture
 {
@@ -48,7 +50,10 @@ public:
     QueryMatch() = default;
     QueryMatch(TextDocument &document, const treesitter::QueryMatch &match);
 
-    const QList<QueryCapture> &captures() const;
+    // The matches share the same captures, they must all come from the same query
+    static QList<QueryMatch> fromMatches(TextDocument &document, const QList<treesitter::QueryMatch> &matches);
+
+    QList<QueryCapture> captures() const;
     bool isEmpty() const;
 
     // Access to captures
@@ -75,7 +80,18 @@ public:
     Q_INVOKABLE QString toString() const;
 
 private:
-    QList<QueryCapture> m_captures;
+    friend class QueryMatchIterator;
+    QueryMatch(const std::shared_ptr<QueryMatchPrivate> &d, const treesitter::QueryMatch &match);
+    static std::shared_ptr<QueryMatchPrivate> createPrivate(TextDocument &document,
+                                                            const treesitter::QueryMatch &match);
+
+    int nameId(const QString &name) const;
+    bool isInRange(int index, const Core::RangeMark &range) const;
+
+    // Captures are stored in d, from m_first to m_first + m_count
+    std::shared_ptr<QueryMatchPrivate> d;
+    int m_first = 0;
+    int m_count = 0;
 };
 
 using QueryMatchList = QList<Core::QueryMatch>;
@@ -0,0 +1,54 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include "rangemark.h"
+
+#include <QObject>
+#include <QPointer>
+#include <QStringList>
+#include <vector>
+
+namespace Core {
+
+class TextDocument;
+
+// Captures of all the matches of a query, shared by the QueryMatch objects.
+// Captures are plain ranges, all updated by a single connection to the document. A capture is only promoted to a
+// RangeMark when a script asks for it.
+class QueryMatchPrivate : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Capture
+    {
+        // Index of the name in the query, interned in m_names
+        int nameId;
+        int start;
+        int end;
+        RangeMark range;
+    };
+
+    explicit QueryMatchPrivate(TextDocument *document, QStringList names);
+
+private:
+    void update(int from, int charsRemoved, int charsAdded);
+    RangeMark range(int index);
+
+    QPointer<TextDocument> m_document;
+    QStringList m_names;
+    std::vector<Capture> m_captures;
+
+    friend class QueryMatch;
+};
+
+} // namespace Core
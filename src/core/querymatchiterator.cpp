@@ -0,0 +1,147 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "querymatchiterator.h"
+#include "codedocument.h"
+#include "profiler.h"
+#include "progressoperation.h"
+#include "querymatch_p.h"
+#include "treesitter/predicates.h"
+#include "utils/log.h"
+
+#include <QJSEngine>
+#include <QPlainTextEdit>
+#include <QTextDocument>
+
+namespace Core {
+
+/*!
+ * \qmltype QueryMatchIterator
+ * \brief Iterates lazily over the matches of a query.
+ * \ingroup CodeDocument
+ * \sa CodeDocument::queryIter
+ *
+ * The QueryMatchIterator follows the Javascript iterable protocol, so it can be used in a `for...of` loop: each call to
+ * `next()` runs the query until the next match is found. Stopping the iteration early skips the work needed to find the
+ * remaining matches, and breaking out of a `for...of` loop closes the iterator.
+ *
+ * ```js
+ * for (const match of document.queryIter("(function_definition) @function")) {
+ *     if (match.get("function").text.includes("TODO")) {
+ *         Message.log("Found a TODO");
+ *         break;
+ *     }
+ * }
+ * ```
+ *
+ * !!! note
+ *     The iteration stops as soon as the document is changed, matches that were already returned stay valid and
+ *     follow the changes.
+ */
+
+/*!
+ * \qmlproperty bool QueryMatchIterator::isDone
+ * Returns true if there are no more matches, or if the iterator has been closed.
+ */
+
+QueryMatchIterator::QueryMatchIterator(CodeDocument *document, std::optional<treesitter::Tree> &&tree,
+                                       const std::shared_ptr<treesitter::Query> &query)
+    : m_document(document)
+    , m_tree(std::move(tree))
+{
+    Q_ASSERT(document);
+    if (!m_tree || !query)
+        return;
+
+    m_cursor.emplace();
+    m_cursor->setProgressCallback([this](uint32_t position, uint32_t size) {
+        if (!m_operation || m_operation->advance(position, size))
+            return true;
+        spdlog::warn("QueryMatchIterator::next: cancelled by the user");
+        return false;
+    });
+    m_cursor->execute(query, m_tree->rootNode(), std::make_unique<treesitter::Predicates>(document->text()));
+
+    // The tree is a copy, so the cursor is still valid after a change, but new matches would be wrong
+    connect(document->textEdit()->document(), &QTextDocument::contentsChange, this, [this]() {
+        m_documentChanged = true;
+    });
+}
+
+QueryMatchIterator::~QueryMatchIterator() = default;
+
+bool QueryMatchIterator::isDone() const
+{
+    return !m_cursor.has_value();
+}
+
+/*!
+ * \qmlmethod object QueryMatchIterator::next()
+ * Returns an object `{value, done}`: `value` is the next [QueryMatch](querymatch.md), and `done` is true if there are
+ * no more matches.
+ */
+QJSValue QueryMatchIterator::next()
+{
+    auto engine = qjsEngine(this);
+    if (!engine) {
+        spdlog::error("{}: no Javascript engine for the iterator", FUNCTION_NAME);
+        return {};
+    }
+
+    const auto match = nextMatch();
+    QJSValue result = engine->newObject();
+    result.setProperty("done", !match.has_value());
+    if (match.has_value())
+        result.setProperty("value", engine->toScriptValue(match.value()));
+    return result;
+}
+
+/*!
+ * \qmlmethod QueryMatchIterator::close()
+ * Stops the iteration, and releases the resources used by the query.
+ *
+ * It's not needed if the iteration is done, otherwise the resources are only released once the iterator is garbage
+ * collected.
+ */
+void QueryMatchIterator::close()
+{
+    m_cursor.reset();
+    m_tree.reset();
+    if (m_document)
+        disconnect(m_document->textEdit()->document(), nullptr, this, nullptr);
+}
+
+std::optional<QueryMatch> QueryMatchIterator::nextMatch()
+{
+    if (!m_cursor)
+        return {};
+
+    if (m_documentChanged || !m_document) {
+        spdlog::warn("{}: the document has changed, the iteration is stopped", FUNCTION_NAME);
+        close();
+        return {};
+    }
+
+    Profiler::Scope scope(Profiler::TreeSitter);
+    ProgressOperation operation(QStringLiteral("Query"), QStringLiteral("matches"));
+    m_operation = &operation;
+    const auto match = m_cursor->nextMatch();
+    m_operation = nullptr;
+    if (!match.has_value()) {
+        close();
+        return {};
+    }
+
+    if (!d)
+        d = QueryMatch::createPrivate(*m_document, match.value());
+    return QueryMatch(d, match.value());
+}
+
+} // namespace Core
@@ -0,0 +1,66 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include "querymatch.h"
+
+#include <QJSValue>
+#include <QObject>
+#include <QPointer>
+#include <memory>
+#include <optional>
+#include <treesitter/query.h>
+#include <treesitter/tree.h>
+
+namespace Core {
+
+class CodeDocument;
+class ProgressOperation;
+class QueryMatchPrivate;
+
+/**
+ * \brief Lazy iterator on the matches of a query, created by CodeDocument::queryIter
+ *
+ * Matches are only computed when requested, the iteration stops as soon as the document is changed.
+ */
+class QueryMatchIterator : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool isDone READ isDone FINAL)
+
+public:
+    ~QueryMatchIterator() override;
+
+    bool isDone() const;
+
+    Q_INVOKABLE QJSValue next();
+    Q_INVOKABLE void close();
+
+    std::optional<Core::QueryMatch> nextMatch();
+
+private:
+    friend class CodeDocument;
+    QueryMatchIterator(CodeDocument *document, std::optional<treesitter::Tree> &&tree,
+                       const std::shared_ptr<treesitter::Query> &query);
+
+    QPointer<CodeDocument> m_document;
+    // Copy of the document tree, the cursor nodes must stay valid even if the document is parsed again
+    std::optional<treesitter::Tree> m_tree;
+    std::optional<treesitter::QueryCursor> m_cursor;
+    // Shared by all matches returned, see QueryMatch
+    std::shared_ptr<QueryMatchPrivate> d;
+    // Only set while searching for the next match, so a long search shows its progress and can be cancelled
+    ProgressOperation *m_operation = nullptr;
+    bool m_documentChanged = false;
+};
+
+} // namespace Core
@@ -11,6 +11,7 @@
 #include "rcdocument.h"
 #include "logger.h"
 #include "rccore/rcfile.h"
+#include "rccore/stream.h"
 #include "utils/log.h"
 
 #include <QBuffer>
@@ -666,8 +667,35 @@ bool RcDocument::writeAssetsToImage(ConversionFlags flags)
     SET_DEFAULT_VALUE(RcAssetColors, flags);
     if (m_cacheAssets.isEmpty())
         convertAssets();
-    RcCore::writeAssetsToImage(m_cacheAssets, static_cast<RcCore::Asset::TransparentColors>(static_cast<int>(flags)));
-    return true;
+    return RcCore::writeAssetsToImage(m_cacheAssets,
+                                      static_cast<RcCore::Asset::TransparentColors>(static_cast<int>(flags)));
+}
+
+/*!
+ * \qmlmethod bool RcDocument::writeAssetsToAtlas(string fileName, ConversionFlags flags)
+ * \sa RcDocument::convertAssets
+ * Writes all the assets in a single atlas image `fileName`, using `flags` for transparency settings. Returns `true` if
+ * no issues.
+ *
+ * Instead of writing one image per asset, like RcDocument::writeAssetsToImage, the assets are packed in one image.
+ * The coordinates of each asset are written in a json file next to the image, with the same base name:
+ *
+ * ```json
+ * {
+ *     "image": "icons.png",
+ *     "icons": [ { "id": "IDR_MAINFRAME_00", "x": 0, "y": 0, "width": 16, "height": 15 }, ... ]
+ * }
+ * ```
+ */
+bool RcDocument::writeAssetsToAtlas(const QString &fileName, ConversionFlags flags)
+{
+    LOG(fileName, flags);
+
+    SET_DEFAULT_VALUE(RcAssetColors, flags);
+    if (m_cacheAssets.isEmpty())
+        convertAssets();
+    return RcCore::writeAssetsToAtlas(m_cacheAssets, fileName,
+                                      static_cast<RcCore::Asset::TransparentColors>(static_cast<int>(flags)));
 }
 
 /*!
@@ -709,6 +737,30 @@ bool RcDocument::writeDialogToUi(const RcCore::Widget &dialog, const QString &fi
     return false;
 }
 
+/*!
+ * \qmlmethod bool RcDocument::writeDialogsToUi(array<string> ids, string path, ConversionFlags flags, real scaleX, real scaleY)
+ * \sa RcDocument::dialog
+ * Converts the dialogs with the given `ids` and writes them as ui files in the directory `path`. If `ids` is empty, all
+ * dialogs are written. Return `true` if no issues.
+ *
+ * Each ui file is named after the dialog id. The dialogs are converted and written in parallel, using the `flags` and
+ * scale factor `scaleX` and `scaleY` for the conversion (see RcDocument::dialog).
+ */
+bool RcDocument::writeDialogsToUi(const QStringList &ids, const QString &path, ConversionFlags flags, double scaleX,
+                                  double scaleY)
+{
+    LOG(ids, path, flags, scaleX, scaleY);
+
+    SET_DEFAULT_VALUE(RcDialogFlags, flags);
+    SET_DEFAULT_VALUE(RcDialogScaleX, scaleX);
+    SET_DEFAULT_VALUE(RcDialogScaleY, scaleY);
+    if (!isDataValid())
+        return false;
+    return RcCore::writeDialogsToUi(data(), ids, path,
+                                    static_cast<RcCore::Widget::ConversionFlags>(static_cast<int>(flags)), scaleX,
+                                    scaleY);
+}
+
 /*!
  * \qmlmethod bool RcDocument::previewDialog(Widget dialog )
  * \sa RcDocument::dialog
@@ -816,13 +868,26 @@ bool RcDocument::doSave(const QString &fileName)
 
 bool RcDocument::doLoad(const QString &fileName)
 {
-    m_rcFile = RcCore::parse(fileName);
+    QFile file(fileName);
+    bool isMerged = false;
+    if (m_rcFile.isValid && m_rcFile.fileName == fileName && file.open(QIODevice::ReadOnly)) {
+        // Reloading the same file: only parse again the blocks changed, the languages stay merged
+        isMerged = RcCore::reparse(m_rcFile, RcCore::Stream(&file).content());
+    } else if (DEFAULT_VALUE(bool, RcSnapshotCache) && !Settings::instance()->isTesting()) {
+        // Use a snapshot of the parsed RC file if possible, parsing big RC files takes time
+        m_rcFile = RcCore::parse(fileName, Settings::instance()->rcSnapshotCachePath());
+    } else {
+        m_rcFile = RcCore::parse(fileName);
+    }
 
     // There should always be one language in a RC file. If not, bail out.
     if (m_rcFile.data.isEmpty())
         return false;
 
-    mergeLanguages();
+    if (isMerged)
+        emit dataChanged();
+    else
+        mergeLanguages();
 
     return true;
 }
@@ -113,8 +113,14 @@ public slots:
     void convertAssets(Core::RcDocument::ConversionFlags flags = DEFAULT_VALUE(ConversionFlag, RcAssetFlags));
     void convertActions(Core::RcDocument::ConversionFlags flags = DEFAULT_VALUE(ConversionFlags, RcAssetFlags));
     bool writeAssetsToImage(Core::RcDocument::ConversionFlags flags = DEFAULT_VALUE(ConversionFlags, RcAssetColors));
+    bool writeAssetsToAtlas(const QString &fileName,
+                            Core::RcDocument::ConversionFlags flags = DEFAULT_VALUE(ConversionFlags, RcAssetColors));
     bool writeAssetsToQrc(const QString &fileName);
     bool writeDialogToUi(const RcCore::Widget &dialog, const QString &fileName);
+    bool writeDialogsToUi(const QStringList &ids, const QString &path,
+                          Core::RcDocument::ConversionFlags flags = DEFAULT_VALUE(ConversionFlags, RcDialogFlags),
+                          double scaleX = DEFAULT_VALUE(double, RcDialogScaleX),
+                          double scaleY = DEFAULT_VALUE(double, RcDialogScaleY));
     void previewDialog(const RcCore::Widget &dialog) const;
     void mergeAllLanguages(const QString &language = DefaultLanguage);
     void mergeLanguages();
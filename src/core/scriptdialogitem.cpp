@@ -10,6 +10,7 @@
 
 #include "scriptdialogitem.h"
 #include "loghighlighter.h"
+#include "progressoperation.h"
 #include "scriptdialogitem_p.h"
 #include "scriptprogressdialog.h"
 #include "scriptrunner.h"
@@ -29,6 +30,7 @@
 #include <QCoreApplication>
 #include <QDialogButtonBox>
 #include <QDoubleSpinBox>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 #include <QJsonDocument>
@@ -45,6 +47,8 @@
 #include <QToolButton>
 #include <QUiLoader>
 #include <QVBoxLayout>
+#include <QWindow>
+#include <algorithm>
 #include <spdlog/sinks/qt_sinks.h>
 
 namespace Core {
@@ -243,7 +247,7 @@ void ScriptDialogItem::firstStep(const QString &firstStep)
     showProgressDialog();
     m_currentStep = 0;
     nextStep(firstStep);
-    updateProgress();
+    updateProgress(true);
 }
 
 /**
@@ -487,10 +491,11 @@ void ScriptDialogItem::showProgressDialog()
 
     connect(m_progressDialog, &ScriptProgressDialog::apply, this, &ScriptDialogItem::continueScript);
     connect(m_progressDialog, &ScriptProgressDialog::abort, this, &ScriptDialogItem::abortScript);
+    connect(m_progressDialog, &ScriptProgressDialog::cancelOperation, this, &ProgressOperation::cancelAll);
 
     m_progressDialogs.push_back(m_progressDialog);
     m_progressDialog->show();
-    updateProgress();
+    updateProgress(true);
 }
 
 void ScriptDialogItem::cleanupProgressDialog()
@@ -503,11 +508,70 @@ void ScriptDialogItem::cleanupProgressDialog()
     }
 }
 
-void ScriptDialogItem::updateProgress()
+namespace {
+// Filter out user input events, except for the progress dialogs, so an operation can be cancelled while nothing else
+// can be changed during the script
+class ProgressInputFilter : public QObject
 {
-    if (!m_progressDialogs.empty()) {
+public:
+    explicit ProgressInputFilter(const QList<ScriptProgressDialog *> &dialogs)
+        : m_dialogs(dialogs)
+    {
+    }
+
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        switch (event->type()) {
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseButtonDblClick:
+        case QEvent::KeyPress:
+        case QEvent::KeyRelease:
+        case QEvent::Shortcut:
+        case QEvent::ShortcutOverride:
+        case QEvent::Wheel:
+            break;
+        default:
+            return false;
+        }
+
+        auto isInDialog = [watched](ScriptProgressDialog *dialog) {
+            if (auto widget = qobject_cast<QWidget *>(watched))
+                return dialog == widget || dialog->isAncestorOf(widget);
+            return watched == dialog->windowHandle();
+        };
+        return !std::ranges::any_of(m_dialogs, isInDialog);
+    }
+
+private:
+    const QList<ScriptProgressDialog *> &m_dialogs;
+};
+}
+
+void ScriptDialogItem::updateProgress(bool force)
+{
+    if (m_progressDialogs.empty())
+        return;
+
+    // This is called for each API call and each query match, only process the events at a limited rate
+    static QElapsedTimer timer;
+    if (!force && timer.isValid() && timer.elapsed() < ProgressInterval)
+        return;
+
+    const auto operation = ProgressOperation::current();
+    for (auto dialog : std::as_const(m_progressDialogs))
+        dialog->setOperationStatus(operation ? operation->statusText() : QString());
+
+    if (operation) {
+        // Let the user cancel the running operation
+        ProgressInputFilter filter(m_progressDialogs);
+        qApp->installEventFilter(&filter);
+        QCoreApplication::processEvents();
+        qApp->removeEventFilter(&filter);
+    } else {
         QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
     }
+    timer.start();
 }
 
 QObject *ScriptDialogItem::data() const
@@ -48,7 +48,9 @@ public:
     // This method is used to redraw the application while a script is running
     // Long-running scripts will otherwise block the GUI, which may look like Knut is hung up.
     // This method should be called in regular intervals to ensure visual progress.
-    static void updateProgress();
+    // The events are processed at most every ProgressInterval ms, unless `force` is true.
+    static void updateProgress(bool force = false);
+    static constexpr int ProgressInterval = 50;
 
     bool isInteractive() const;
     void setInteractive(bool interactive);
@@ -0,0 +1,200 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "scriptjob.h"
+#include "scriptmanager.h"
+#include "utils/log.h"
+
+#include <QJSEngine>
+#include <QMetaEnum>
+#include <QtQml/private/qjsvalue_p.h>
+#include <QtQml/private/qv4engine_p.h>
+#include <utility>
+
+namespace Core {
+
+/*!
+ * \qmltype ScriptJob
+ * \brief Script running asynchronously, created by `Utils.runScriptAsync`.
+ * \ingroup Utilities
+ *
+ * Jobs are started by order of priority, then by order of creation. The maximum number of jobs running at the same
+ * time is set by the `maxConcurrentJobs` setting, there is no limit by default, see the overview.
+ *
+ * ```js
+ * let job = Utils.runScriptAsync("path/to/script.js", ScriptJob.High);
+ * job.then(result => Message.log("Result: " + result),
+ *          reason => Message.warning("Script " + reason));
+ * ```
+ */
+
+/*!
+ * \qmlproperty int ScriptJob::id
+ * Unique identifier of the job.
+ */
+/*!
+ * \qmlproperty string ScriptJob::fileName
+ * Name of the script file run by the job.
+ */
+/*!
+ * \qmlproperty int ScriptJob::priority
+ * Priority of the job, jobs with a higher priority are run first. It can be any number, or one of:
+ *
+ * - `ScriptJob.Low`
+ * - `ScriptJob.Normal`
+ * - `ScriptJob.High`
+ */
+/*!
+ * \qmlproperty Status ScriptJob::status
+ * Current status of the job:
+ *
+ * - `ScriptJob.Pending`: the job is waiting in the queue
+ * - `ScriptJob.Running`
+ * - `ScriptJob.Finished`
+ * - `ScriptJob.Failed`: the script has errors, or doesn't exist
+ * - `ScriptJob.Cancelled`
+ */
+/*!
+ * \qmlproperty bool ScriptJob::isDone
+ * Returns true if the job is finished, failed or cancelled.
+ */
+/*!
+ * \qmlproperty var ScriptJob::result
+ * Value returned by the script, once the job is done.
+ */
+/*!
+ * \qmlproperty int ScriptJob::elapsed
+ * Time spent running the script, in milliseconds.
+ */
+/*!
+ * \qmlsignal ScriptJob::onStarted()
+ * This handler is called when the script starts running.
+ */
+/*!
+ * \qmlsignal ScriptJob::onFinished(var result)
+ * This handler is called when the job is done, whatever its final status.
+ */
+
+ScriptJob::ScriptJob(int id, const QString &fileName, nlohmann::json &&data, int priority, bool log,
+                     QObject *parent)
+    : QObject(parent)
+    , m_id(id)
+    , m_fileName(fileName)
+    , m_data(std::move(data))
+    , m_priority(priority)
+    , m_log(log)
+{
+}
+
+ScriptJob::~ScriptJob() = default;
+
+int ScriptJob::id() const
+{
+    return m_id;
+}
+
+QString ScriptJob::fileName() const
+{
+    return m_fileName;
+}
+
+int ScriptJob::priority() const
+{
+    return m_priority;
+}
+
+ScriptJob::Status ScriptJob::status() const
+{
+    return m_status;
+}
+
+bool ScriptJob::isDone() const
+{
+    return m_status == Finished || m_status == Failed || m_status == Cancelled;
+}
+
+QVariant ScriptJob::result() const
+{
+    return m_result;
+}
+
+int ScriptJob::elapsed() const
+{
+    if (m_status == Running)
+        return static_cast<int>(m_timer.elapsed());
+    return static_cast<int>(m_elapsed);
+}
+
+/*!
+ * \qmlmethod bool ScriptJob::cancel()
+ * Removes the job from the queue. Returns false if the job has already started, as a running script can't be
+ * stopped.
+ */
+bool ScriptJob::cancel()
+{
+    return ScriptManager::instance()->cancelJob(this);
+}
+
+/*!
+ * \qmlmethod ScriptJob ScriptJob::then(function onFinished, function onError)
+ * Calls `onFinished` with the result of the script once the job is finished, or `onError` with the status (`"Failed"`
+ * or `"Cancelled"`) if it's not. The callbacks are called immediately if the job is already done.
+ *
+ * Returns the job, so the calls can be chained.
+ */
+ScriptJob *ScriptJob::then(const QJSValue &onFinished, const QJSValue &onError)
+{
+    m_callbacks.emplace_back(onFinished, onError);
+    if (isDone())
+        callCallbacks();
+    return this;
+}
+
+void ScriptJob::setStatus(Status status)
+{
+    if (m_status == status)
+        return;
+
+    if (status == Running) {
+        m_timer.start();
+    } else if (m_status == Running) {
+        m_elapsed = m_timer.elapsed();
+    }
+    m_status = status;
+    emit statusChanged();
+
+    if (status == Running) {
+        emit started();
+    } else if (isDone()) {
+        emit finished(m_result);
+        callCallbacks();
+    }
+}
+
+void ScriptJob::callCallbacks()
+{
+    const auto callbacks = std::exchange(m_callbacks, {});
+    for (const auto &[onFinished, onError] : callbacks) {
+        const auto &callback = m_status == Finished ? onFinished : onError;
+        // The engine may have been deleted since the callback was registered
+        auto v4 = QJSValuePrivate::engine(&callback);
+        if (!v4 || !callback.isCallable())
+            continue;
+
+        const QJSValue argument = m_status == Finished
+            ? v4->jsEngine()->toScriptValue(m_result)
+            : QJSValue(QString::fromLatin1(QMetaEnum::fromType<Status>().valueToKey(m_status)));
+        const QJSValue value = callback.call({argument});
+        if (value.isError())
+            spdlog::error("{}: error in callback for {} - {}", FUNCTION_NAME, m_fileName, value.toString());
+    }
+}
+
+} // namespace Core
@@ -0,0 +1,93 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QJSValue>
+#include <QObject>
+#include <QPointer>
+#include <QVariant>
+#include <nlohmann/json.hpp>
+#include <vector>
+
+class QJSEngine;
+
+namespace Core {
+
+/**
+ * \brief Script run scheduled by the ScriptManager
+ *
+ * A job is owned by the ScriptManager until it's done. Jobs created from a script are then owned by the JavaScript
+ * engine, other jobs are deleted.
+ */
+class ScriptJob : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int id READ id CONSTANT FINAL)
+    Q_PROPERTY(QString fileName READ fileName CONSTANT FINAL)
+    Q_PROPERTY(int priority READ priority CONSTANT FINAL)
+    Q_PROPERTY(Status status READ status NOTIFY statusChanged FINAL)
+    Q_PROPERTY(bool isDone READ isDone NOTIFY statusChanged FINAL)
+    Q_PROPERTY(QVariant result READ result NOTIFY statusChanged FINAL)
+    Q_PROPERTY(int elapsed READ elapsed NOTIFY statusChanged FINAL)
+
+public:
+    enum Status { Pending, Running, Finished, Failed, Cancelled };
+    Q_ENUM(Status)
+
+    enum Priority { Low = -1, Normal = 0, High = 1 };
+    Q_ENUM(Priority)
+
+    ~ScriptJob() override;
+
+    int id() const;
+    QString fileName() const;
+    int priority() const;
+    Status status() const;
+    bool isDone() const;
+    QVariant result() const;
+    int elapsed() const;
+
+    Q_INVOKABLE bool cancel();
+    Q_INVOKABLE Core::ScriptJob *then(const QJSValue &onFinished, const QJSValue &onError = {});
+
+signals:
+    void statusChanged();
+    void started();
+    void finished(const QVariant &result);
+
+private:
+    friend class ScriptManager;
+    ScriptJob(int id, const QString &fileName, nlohmann::json &&data, int priority, bool log, QObject *parent);
+
+    void setStatus(Status status);
+    void callCallbacks();
+
+    const int m_id;
+    const QString m_fileName;
+    nlohmann::json m_data;
+    const int m_priority;
+    const bool m_log;
+
+    Status m_status = Pending;
+    QVariant m_result;
+    // Set if the script has errors, the job is then failed once the script is done
+    bool m_hasError = false;
+    QElapsedTimer m_timer;
+    qint64 m_elapsed = 0;
+
+    std::vector<std::pair<QJSValue, QJSValue>> m_callbacks;
+    // Engine owning the job once done, if created from a script
+    QPointer<QJSEngine> m_engine;
+};
+
+} // namespace Core
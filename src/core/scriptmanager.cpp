@@ -15,14 +15,19 @@
 #include "settings.h"
 #include "utils/log.h"
 
+#include <QDataStream>
 #include <QDir>
 #include <QDirIterator>
 #include <QFile>
 #include <QFileInfo>
 #include <QFileSystemWatcher>
+#include <QJSEngine>
+#include <QSaveFile>
+#include <QSet>
 #include <QTextStream>
 #include <QTimer>
-#include <kdalgorithms.h>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
 
 namespace Core {
 
@@ -30,12 +35,21 @@ ScriptManager::ScriptManager(QObject *parent)
     : QObject(parent)
     , m_watcher(new QFileSystemWatcher(this))
     , m_runner(new ScriptRunner(this))
+    , m_catalogFileName(Settings::instance()->scriptCachePath() + "/catalog")
 {
     m_instance = this;
 
+    connect(&m_scanWatcher, &QFutureWatcher<ScanResult>::finished, this, &ScriptManager::applyScan);
     connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &ScriptManager::updateScriptDirectory);
     connect(Settings::instance(), &Settings::settingsLoaded, this, &ScriptManager::updateDirectories);
     updateDirectories();
+
+    connect(Settings::instance(), &Settings::settingsLoaded, this, &ScriptManager::updateMaxConcurrentJobs);
+    connect(Settings::instance(), &Settings::settingsChanged, this, [this](const QString &path) {
+        if (path == Settings::MaxConcurrentJobs)
+            updateMaxConcurrentJobs();
+    });
+    updateMaxConcurrentJobs();
 }
 
 ScriptManager::~ScriptManager()
@@ -79,6 +93,11 @@ QAbstractItemModel *ScriptManager::model()
 
 void ScriptManager::runScript(const QString &fileName, nlohmann::json &&data, bool async, bool log)
 {
+    if (async) {
+        runScriptAsync(fileName, std::move(data), ScriptJob::Normal, log);
+        return;
+    }
+
     if (log)
         spdlog::debug("==> Start script {}", fileName);
     auto endScriptCallback = [this, log, fileName]() {
@@ -86,69 +105,347 @@ void ScriptManager::runScript(const QString &fileName, nlohmann::json &&data, bo
             spdlog::debug("<== End script {}", fileName);
         emit scriptFinished(m_result);
     };
+    m_result = doRunScript(fileName, std::move(data), endScriptCallback);
+}
 
-    if (async)
-        QTimer::singleShot(0, this, [this, fileName, data = std::move(data), endScriptCallback]() mutable {
-            doRunScript(fileName, std::move(data), endScriptCallback);
-        });
+/**
+ * Queues the script `fileName`, and returns the job running it. The job is started once all jobs with a higher or
+ * equal priority are started, and the number of running jobs is below the limit.
+ * If `engine` is set, the job is owned by this JavaScript engine once done, as long as the engine exists.
+ */
+ScriptJob *ScriptManager::runScriptAsync(const QString &fileName, nlohmann::json &&data, int priority, bool log,
+                                         QJSEngine *engine)
+{
+    auto job = new ScriptJob(m_nextJobId++, fileName, std::move(data), priority, log, this);
+    if (engine) {
+        job->m_engine = engine;
+        QJSEngine::setObjectOwnership(job, QJSEngine::JavaScriptOwnership);
+    }
+    auto it = std::ranges::upper_bound(m_pendingJobs, priority, std::greater {}, &ScriptJob::priority);
+    m_pendingJobs.insert(it, job);
+    if (m_maxConcurrentJobs > 0 && std::ssize(m_runningJobs) >= m_maxConcurrentJobs)
+        spdlog::info("{}: {} queued, waiting for {} running script(s)", FUNCTION_NAME, fileName, m_runningJobs.size());
+
+    emit jobQueued(job);
+    emit queueChanged(static_cast<int>(m_pendingJobs.size()), static_cast<int>(m_runningJobs.size()));
+    scheduleJobs();
+    return job;
+}
+
+/**
+ * Cancels a pending job. Running jobs can't be cancelled, returns false in this case.
+ */
+bool ScriptManager::cancelJob(ScriptJob *job)
+{
+    auto it = std::ranges::find(m_pendingJobs, job);
+    if (it == m_pendingJobs.end())
+        return false;
+
+    m_pendingJobs.erase(it);
+    job->setStatus(ScriptJob::Cancelled);
+    emit jobFinished(job);
+    emit queueChanged(static_cast<int>(m_pendingJobs.size()), static_cast<int>(m_runningJobs.size()));
+    releaseJob(job);
+    return true;
+}
+
+QList<ScriptJob *> ScriptManager::jobs() const
+{
+    QList<ScriptJob *> result(m_runningJobs.cbegin(), m_runningJobs.cend());
+    result.append(QList<ScriptJob *>(m_pendingJobs.cbegin(), m_pendingJobs.cend()));
+    return result;
+}
+
+void ScriptManager::scheduleJobs()
+{
+    // Jobs are always started from the event loop, never while the caller is still running
+    if (m_isScheduled)
+        return;
+    m_isScheduled = true;
+    QTimer::singleShot(0, this, [this]() {
+        m_isScheduled = false;
+        auto canStart = [this]() {
+            return m_maxConcurrentJobs <= 0 || std::ssize(m_runningJobs) < m_maxConcurrentJobs;
+        };
+        while (!m_pendingJobs.empty() && canStart()) {
+            auto job = m_pendingJobs.front();
+            m_pendingJobs.erase(m_pendingJobs.begin());
+            startJob(job);
+        }
+    });
+}
+
+void ScriptManager::startJob(ScriptJob *job)
+{
+    m_runningJobs.push_back(job);
+    job->setStatus(ScriptJob::Running);
+    emit jobStarted(job);
+    emit queueChanged(static_cast<int>(m_pendingJobs.size()), static_cast<int>(m_runningJobs.size()));
+
+    if (job->m_log)
+        spdlog::debug("==> Start script {}", job->fileName());
+
+    const QFileInfo fi(job->fileName());
+    const bool isReadable = fi.exists() && fi.isReadable();
+
+    // The end callback is called once the script is done, from the event loop
+    job->m_result = doRunScript(job->fileName(), std::move(job->m_data), [this, job]() {
+        finishJob(job);
+    });
+    job->m_hasError = m_runner->hasError() || !isReadable;
+    // The runner doesn't call the end callback if the script can't be read
+    if (!isReadable)
+        finishJob(job);
+}
+
+void ScriptManager::finishJob(ScriptJob *job)
+{
+    std::erase(m_runningJobs, job);
+    job->setStatus(job->m_hasError ? ScriptJob::Failed : ScriptJob::Finished);
+    if (job->m_log)
+        spdlog::debug("<== End script {} ({} ms)", job->fileName(), job->elapsed());
+
+    emit scriptFinished(job->result());
+    emit jobFinished(job);
+    emit queueChanged(static_cast<int>(m_pendingJobs.size()), static_cast<int>(m_runningJobs.size()));
+    releaseJob(job);
+    scheduleJobs();
+}
+
+void ScriptManager::releaseJob(ScriptJob *job)
+{
+    // Jobs created from a script are garbage collected by the JavaScript engine, once unparented. If the engine has
+    // been deleted in the meantime, nothing would collect it.
+    if (job->m_engine && QJSEngine::objectOwnership(job) == QJSEngine::JavaScriptOwnership)
+        job->setParent(nullptr);
     else
-        doRunScript(fileName, std::move(data), endScriptCallback);
+        job->deleteLater();
+}
+
+void ScriptManager::updateMaxConcurrentJobs()
+{
+    m_maxConcurrentJobs = DEFAULT_VALUE(int, MaxConcurrentJobs);
+    scheduleJobs();
+}
+
+void ScriptManager::addScript(Script &&script)
+{
+    emit aboutToAddScript(script, static_cast<int>(m_scriptList.size()));
+    m_scriptList.push_back(std::move(script));
+    emit scriptAdded(m_scriptList.back());
+}
+
+static bool isInDirectory(const QString &fileName, const QString &path)
+{
+    return QFileInfo(fileName).absolutePath() == path;
 }
 
-void ScriptManager::addScript(const QString &fileName)
+// The description of a script is its first line, if it's a comment
+static std::optional<QString> scriptDescription(const QString &fileName)
 {
     QFile file(fileName);
     if (!file.open(QIODevice::ReadOnly))
-        return;
+        return {};
 
     QTextStream stream(&file);
     const auto line = stream.readLine();
-    const QString description = line.startsWith("//") ? line.mid(2).simplified() : "";
+    return line.startsWith("//") ? line.mid(2).simplified() : QString("");
+}
+
+/**
+ * Lists the scripts in `path`, only the scripts not in the `catalog`, or changed since, are read.
+ * This is run in a background thread. The catalog is loaded from `catalogFileName` first, if set.
+ */
+ScriptManager::ScanResult ScriptManager::scanDirectory(const QString &path, Catalog catalog,
+                                                       const QString &catalogFileName)
+{
+    ScanResult result {.path = path};
+    if (!catalogFileName.isEmpty()) {
+        catalog = loadCatalog(catalogFileName);
+        result.catalog = catalog;
+    }
 
-    const QFileInfo fi(fileName);
+    QDirIterator it(path, {"*.js", "*.qml"}, QDir::Files);
+    while (it.hasNext()) {
+        const QFileInfo fi = it.nextFileInfo();
+        const QString fileName = fi.filePath();
+        const qint64 lastModified = fi.lastModified().toMSecsSinceEpoch();
 
-    Script script {fi.fileName(), fileName, description};
-    emit aboutToAddScript(script, static_cast<int>(m_scriptList.size()));
-    m_scriptList.push_back(std::move(script));
-    emit scriptAdded(m_scriptList.back());
+        ScriptMetadata metadata;
+        auto cached = catalog.constFind(fileName);
+        if (cached != catalog.cend() && cached->lastModified == lastModified && cached->size == fi.size()) {
+            metadata = cached.value();
+        } else {
+            auto description = scriptDescription(fileName);
+            if (!description)
+                continue;
+            metadata = {.description = std::move(*description), .lastModified = lastModified, .size = fi.size()};
+            ++result.readCount;
+        }
+        result.scripts.push_back({fi.fileName(), fileName, metadata.description});
+        result.metadata.insert(fileName, std::move(metadata));
+    }
+    return result;
 }
 
-static QStringList scriptListFromDir(const QString &path)
+// Catalog
+// The catalog is a binary serialization of the metadata of all scripts, stored in the script cache directory.
+constexpr quint32 CatalogMagic = 0x4b534354; // KSCT
+constexpr qint32 CatalogVersion = 1;
+
+ScriptManager::Catalog ScriptManager::loadCatalog(const QString &fileName)
 {
-    const QStringList filter {"*.js", "*.qml"};
-    QDirIterator it(path, filter, QDir::Files);
-    QStringList files;
-    files.reserve(filter.count());
-    while (it.hasNext())
-        files << it.next();
-    return files;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    QDataStream in(&file);
+    quint32 magic;
+    qint32 version;
+    in >> magic >> version;
+    if (magic != CatalogMagic || version != CatalogVersion)
+        return {};
+    in.setVersion(QDataStream::Qt_6_0);
+
+    qint32 count = 0;
+    in >> count;
+    Catalog catalog;
+    for (int i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString scriptName;
+        ScriptMetadata metadata;
+        in >> scriptName >> metadata.description >> metadata.lastModified >> metadata.size;
+        catalog.insert(scriptName, std::move(metadata));
+    }
+    if (in.status() != QDataStream::Ok)
+        return {};
+    return catalog;
+}
+
+void ScriptManager::saveCatalog()
+{
+    // Only keep the scripts of the current directories
+    for (auto it = m_catalog.begin(); it != m_catalog.end();) {
+        if (m_directories.contains(QFileInfo(it.key()).absolutePath()))
+            ++it;
+        else
+            it = m_catalog.erase(it);
+    }
+
+    QDir().mkpath(QFileInfo(m_catalogFileName).absolutePath());
+    QSaveFile file(m_catalogFileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        spdlog::warn("{}: can't write script catalog {}", FUNCTION_NAME, m_catalogFileName);
+        return;
+    }
+
+    QDataStream out(&file);
+    out << CatalogMagic << CatalogVersion;
+    out.setVersion(QDataStream::Qt_6_0);
+    out << static_cast<qint32>(m_catalog.size());
+    for (auto it = m_catalog.cbegin(); it != m_catalog.cend(); ++it)
+        out << it.key() << it->description << it->lastModified << it->size;
+    if (out.status() != QDataStream::Ok || !file.commit())
+        spdlog::warn("{}: can't write script catalog {}", FUNCTION_NAME, m_catalogFileName);
+    m_isCatalogChanged = false;
 }
 
 void ScriptManager::updateScriptDirectory(const QString &path)
 {
-    const QStringList filesInDir = scriptListFromDir(path);
+    if (!m_scanQueue.contains(path))
+        m_scanQueue.push_back(path);
+    startNextScan();
+}
+
+void ScriptManager::startNextScan()
+{
+    if (m_isScanning)
+        return;
+
+    if (m_scanQueue.isEmpty()) {
+        if (m_isCatalogChanged)
+            saveCatalog();
+        return;
+    }
+
+    const QString path = m_scanQueue.takeFirst();
+    // The catalog is loaded by the first scan, so nothing is read from the disk before the event loop is running
+    const QString catalogFileName = m_isCatalogLoaded ? QString() : m_catalogFileName;
+    m_isCatalogLoaded = true;
+    m_isScanning = true;
+    m_scanWatcher.setFuture(QtConcurrent::run(&ScriptManager::scanDirectory, path, m_catalog, catalogFileName));
+}
+
+void ScriptManager::applyScan()
+{
+    // The watcher state is only updated from the event loop, so check the future itself: waitForScripts applies the
+    // scan without going through the event loop. The finished signal may then come for a scan already applied, or
+    // for a previous scan while the current one is still running.
+    if (!m_isScanning || !m_scanWatcher.future().isFinished())
+        return;
+    m_isScanning = false;
+
+    auto result = m_scanWatcher.result();
+    if (result.catalog)
+        m_catalog.insert(*result.catalog);
+
+    // Update the catalog with the scripts of the directory, removing deleted scripts
+    for (auto it = m_catalog.begin(); it != m_catalog.end();) {
+        if (isInDirectory(it.key(), result.path) && !result.metadata.contains(it.key())) {
+            it = m_catalog.erase(it);
+            m_isCatalogChanged = true;
+        } else {
+            ++it;
+        }
+    }
+    m_catalog.insert(result.metadata);
+    m_isCatalogChanged |= result.readCount > 0;
+    spdlog::trace("{}: {} scripts in {}, {} read", FUNCTION_NAME, result.scripts.size(), result.path,
+                  result.readCount);
+
+    // The directory may have been removed during the scan
+    if (m_directories.contains(result.path))
+        updateScripts(result.path, std::move(result.scripts));
+
+    startNextScan();
+}
+
+void ScriptManager::waitForScripts()
+{
+    while (m_isScanning) {
+        m_scanWatcher.future().waitForFinished();
+        applyScan();
+    }
+}
+
+void ScriptManager::updateScripts(const QString &path, ScriptList &&scripts)
+{
+    QSet<QString> fileNames;
+    for (const auto &script : std::as_const(scripts))
+        fileNames.insert(script.fileName);
 
     // Remove deleted scripts
     auto it = m_scriptList.begin();
     while (it != m_scriptList.end()) {
-        const auto &script = *it;
-
         // Only remove the script if it was actually in the directory that had changes
-        if (script.fileName.startsWith(path) && !filesInDir.contains(script.fileName)) {
+        if (isInDirectory(it->fileName, path) && !fileNames.contains(it->fileName)) {
             it = removeScript(it);
         } else {
             ++it;
         }
     }
 
-    auto scriptToFileName = [](const auto &script) {
-        return script.fileName;
-    };
-    auto currentFileNames = kdalgorithms::transformed(m_scriptList, scriptToFileName);
-    // Add new scripts
-    for (const auto &fileName : filesInDir) {
-        if (!kdalgorithms::contains(currentFileNames, fileName)) {
-            addScript(fileName);
+    QHash<QString, int> indexes;
+    for (int i = 0; i < static_cast<int>(m_scriptList.size()); ++i)
+        indexes.insert(m_scriptList.at(i).fileName, i);
+
+    // Add new scripts, and update changed ones
+    for (auto &script : scripts) {
+        auto index = indexes.constFind(script.fileName);
+        if (index == indexes.cend()) {
+            addScript(std::move(script));
+        } else if (auto &current = m_scriptList[index.value()]; current.description != script.description) {
+            current.description = script.description;
+            emit scriptChanged(current, index.value());
         }
     }
 }
@@ -166,23 +463,20 @@ void ScriptManager::addScriptsFromPath(const QString &path)
 
     m_directories.append(path);
     m_watcher->addPath(path);
-
-    const QStringList files = scriptListFromDir(path);
-    for (const auto &fileName : files)
-        addScript(fileName);
+    updateScriptDirectory(path);
 }
 
 void ScriptManager::removeScriptsFromPath(const QString &path)
 {
     m_directories.removeAll(path);
+    m_scanQueue.removeAll(path);
 
     if (m_watcher->directories().contains(path))
         m_watcher->removePath(path);
 
-    const QStringList files = scriptListFromDir(path);
     auto it = m_scriptList.begin();
     while (it != m_scriptList.end()) {
-        if (files.contains(it->fileName)) {
+        if (isInDirectory(it->fileName, path)) {
             it = removeScript(it);
         } else {
             ++it;
@@ -199,17 +493,40 @@ ScriptManager::ScriptList::iterator ScriptManager::removeScript(const ScriptList
     return it;
 }
 
-void ScriptManager::doRunScript(const QString &fileName, nlohmann::json &&data, const std::function<void()> &endFunc)
+QVariant ScriptManager::doRunScript(const QString &fileName, nlohmann::json &&data,
+                                   const std::function<void()> &endFunc)
 {
-    m_result = m_runner->runScript(fileName, std::move(data), endFunc);
+    auto result = m_runner->runScript(fileName, std::move(data), endFunc);
     if (m_runner->hasError()) {
         const auto errors = m_runner->errors();
         for (const auto &error : errors)
             spdlog::error("{}({}): {}", error.url().toLocalFile(), error.line(), error.description());
     } else {
-        if (m_result.isValid())
-            spdlog::info("{}: Script result is {}", FUNCTION_NAME, m_result.toString());
+        if (result.isValid())
+            spdlog::info("{}: Script result is {}", FUNCTION_NAME, result.toString());
+    }
+    return result;
+}
+
+/**
+ * Compiles all scripts in the script directories and their sub-directories, without running them, so the compiled
+ * units are available in the disk cache for the next runs.
+ * Returns the number of scripts that failed to compile.
+ */
+int ScriptManager::precompileScripts()
+{
+    int count = 0;
+    int errors = 0;
+    for (const auto &path : std::as_const(m_directories)) {
+        QDirIterator it(path, {"*.js", "*.qml"}, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            ++count;
+            if (!m_runner->compileScript(it.next()))
+                ++errors;
+        }
     }
+    spdlog::info("{}: {} scripts compiled, {} errors", FUNCTION_NAME, count, errors);
+    return errors;
 }
 
 void ScriptManager::updateDirectories()
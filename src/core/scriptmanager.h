@@ -10,13 +10,20 @@
 
 #pragma once
 
+#include "scriptjob.h"
+
+#include <QFutureWatcher>
+#include <QHash>
 #include <QObject>
 #include <QStringList>
 #include <QVariant>
 #include <functional>
+#include <optional>
 #include <nlohmann/json.hpp>
 #include <vector>
 
+class QJSEngine;
+
 class QFileSystemWatcher;
 class QAbstractItemModel;
 
@@ -31,6 +38,13 @@ class ScriptRunner;
  *
  * Scripts directory are watched using a QFileSystemWatcher, to update
  * the list of script in case one is added or deleted.
+ *
+ * Directories are scanned in a background thread, one after the other, and the scripts are added once the scan is
+ * done. The metadata of the scripts is stored in a catalog on disk, so only new or changed scripts are read.
+ *
+ * Asynchronous runs are queued as jobs, sorted by priority. The number of jobs running at the same time is limited by
+ * the MaxConcurrentJobs setting: scripts all run on the GUI thread, but a script with a dialog is running until the
+ * dialog is closed.
  */
 class ScriptManager : public QObject
 {
@@ -56,17 +70,34 @@ public:
 
     QStringList directories() const;
 
+    // Wait until all directories are scanned, and the script list is up-to-date
+    void waitForScripts();
+
     static QAbstractItemModel *model();
 
     void runScript(const QString &fileName, nlohmann::json &&data = nlohmann::json::object(), bool async = true,
                    bool log = true);
+    ScriptJob *runScriptAsync(const QString &fileName, nlohmann::json &&data = nlohmann::json::object(),
+                              int priority = ScriptJob::Normal, bool log = true, QJSEngine *engine = nullptr);
+    bool cancelJob(ScriptJob *job);
+
+    // Pending and running jobs
+    QList<ScriptJob *> jobs() const;
+
+    int precompileScripts();
 
 signals:
     void scriptFinished(const QVariant &result);
 
+    void jobQueued(Core::ScriptJob *job);
+    void jobStarted(Core::ScriptJob *job);
+    void jobFinished(Core::ScriptJob *job);
+    void queueChanged(int pendingCount, int runningCount);
+
     // Added to allow models to call beginInsertRows, etc. correctly
     void aboutToAddScript(const Core::ScriptManager::Script &script, int index);
     void scriptAdded(const Core::ScriptManager::Script &script);
+    void scriptChanged(const Core::ScriptManager::Script &script, int index);
 
     // Added to allow models to emit abouToAddRow, etc. correctly
     void aboutToRemoveScript(const Core::ScriptManager::Script &script, int index);
@@ -76,11 +107,44 @@ private:
     friend class KnutCore;
     explicit ScriptManager(QObject *parent = nullptr);
 
-    void addScript(const QString &fileName);
+    struct ScriptMetadata
+    {
+        QString description;
+        qint64 lastModified = 0;
+        qint64 size = 0;
+    };
+    using Catalog = QHash<QString, ScriptMetadata>;
+
+    struct ScanResult
+    {
+        QString path;
+        ScriptList scripts;
+        // Metadata of the scripts in the directory
+        Catalog metadata;
+        // Set if the catalog has been loaded by the scan
+        std::optional<Catalog> catalog;
+        int readCount = 0;
+    };
+
+    static ScanResult scanDirectory(const QString &path, Catalog catalog, const QString &catalogFileName);
+    static Catalog loadCatalog(const QString &fileName);
+    void saveCatalog();
+
+    void startNextScan();
+    void applyScan();
+
+    void addScript(Script &&script);
     void addScriptsFromPath(const QString &path);
     void removeScriptsFromPath(const QString &path);
+    void updateScripts(const QString &path, ScriptList &&scripts);
 
-    void doRunScript(const QString &fileName, nlohmann::json &&data, const std::function<void()> &endFunc);
+    QVariant doRunScript(const QString &fileName, nlohmann::json &&data, const std::function<void()> &endFunc);
+
+    void scheduleJobs();
+    void startJob(ScriptJob *job);
+    void finishJob(ScriptJob *job);
+    void releaseJob(ScriptJob *job);
+    void updateMaxConcurrentJobs();
 
     void updateDirectories();
     void updateScriptDirectory(const QString &path);
@@ -96,6 +160,22 @@ private:
     ScriptList m_scriptList;
     QStringList m_directories;
     QVariant m_result;
+
+    // Directories waiting to be scanned, the scans are done one at a time
+    QStringList m_scanQueue;
+    QFutureWatcher<ScanResult> m_scanWatcher;
+    bool m_isScanning = false;
+    Catalog m_catalog;
+    QString m_catalogFileName;
+    bool m_isCatalogLoaded = false;
+    bool m_isCatalogChanged = false;
+
+    // Pending jobs are sorted by priority, then by creation
+    std::vector<ScriptJob *> m_pendingJobs;
+    std::vector<ScriptJob *> m_runningJobs;
+    int m_nextJobId = 1;
+    int m_maxConcurrentJobs = 0;
+    bool m_isScheduled = false;
 };
 
 } // namespace Core
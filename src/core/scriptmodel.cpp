@@ -26,6 +26,7 @@ ScriptModel::ScriptModel(ScriptManager *parent)
 
     connect(parent, &ScriptManager::scriptAdded, this, &ScriptModel::onScriptAdded);
     connect(parent, &ScriptManager::scriptRemoved, this, &ScriptModel::onScriptRemoved);
+    connect(parent, &ScriptManager::scriptChanged, this, &ScriptModel::onScriptChanged);
 }
 
 const ScriptManager::ScriptList &scriptList()
@@ -53,6 +54,11 @@ void ScriptModel::onScriptRemoved(const Core::ScriptManager::Script &)
     endRemoveRows();
 }
 
+void ScriptModel::onScriptChanged(const Core::ScriptManager::Script &, int index)
+{
+    emit dataChanged(this->index(index, 0), this->index(index, ColumnCount - 1));
+}
+
 int ScriptModel::columnCount(const QModelIndex &parent) const
 {
     return parent.isValid() ? 0 : ColumnCount;
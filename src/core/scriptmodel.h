@@ -53,6 +53,7 @@ private:
 
     void onScriptAdded(const Core::ScriptManager::Script &);
     void onScriptRemoved(const Core::ScriptManager::Script &);
+    void onScriptChanged(const Core::ScriptManager::Script &, int);
 
     QVariant displayData(const Core::ScriptManager::Script &script, int column) const;
 
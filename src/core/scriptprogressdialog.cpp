@@ -22,8 +22,11 @@ ScriptProgressDialog::ScriptProgressDialog(QWidget *parent)
 
     ui->buttonBox->button(QDialogButtonBox::Yes)->setText(tr("Continue"));
     ui->logsWidget->hide();
+    ui->operationStatusLabel->hide();
+    ui->cancelOperationButton->hide();
     connect(ui->buttonBox, &QDialogButtonBox::accepted, this, &ScriptProgressDialog::apply);
     connect(ui->buttonBox, &QDialogButtonBox::rejected, this, &ScriptProgressDialog::abort);
+    connect(ui->cancelOperationButton, &QPushButton::clicked, this, &ScriptProgressDialog::cancelOperation);
 }
 
 ScriptProgressDialog::~ScriptProgressDialog() = default;
@@ -65,6 +68,13 @@ void ScriptProgressDialog::setReadOnly(bool readOnly)
     ui->buttonBox->setEnabled(!readOnly);
 }
 
+void ScriptProgressDialog::setOperationStatus(const QString &status)
+{
+    ui->operationStatusLabel->setText(status);
+    ui->operationStatusLabel->setVisible(!status.isEmpty());
+    ui->cancelOperationButton->setVisible(!status.isEmpty());
+}
+
 QPlainTextEdit *ScriptProgressDialog::logsWidget()
 {
     return ui->logsWidget;
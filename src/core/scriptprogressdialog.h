@@ -32,6 +32,8 @@ public:
 
     void setInteractive(bool interactive);
     void setReadOnly(bool readOnly);
+    // Status of the long-running operation, if any: the operation can be cancelled while it's shown
+    void setOperationStatus(const QString &status);
 
     int value() const;
 
@@ -40,6 +42,7 @@ public:
 signals:
     void apply();
     void abort();
+    void cancelOperation();
 
 private:
     std::unique_ptr<Ui::ScriptProgressDialog> ui;
@@ -12,6 +12,7 @@
 #include "classsymbol.h"
 #include "cppdocument.h"
 #include "dir.h"
+#include "documentsnapshot.h"
 #include "file.h"
 #include "fileinfo.h"
 #include "functionsymbol.h"
@@ -23,6 +24,7 @@
 #include "rcdocument.h"
 #include "scriptdialogitem.h"
 #include "scriptitem.h"
+#include "scriptjob.h"
 #include "settings.h"
 #include "symbol.h"
 #include "textdocument.h"
@@ -30,20 +32,138 @@
 #include "utils.h"
 #include "utils/log.h"
 
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPointer>
+#include <QQmlAbstractUrlInterceptor>
 #include <QQuickItem>
 #include <QQuickView>
 #include <QQuickWindow>
+#include <QTimer>
 #include <QUrl>
 #include <QtQml/private/qqmlengine_p.h>
+#include <algorithm>
 #include <kdalgorithms.h>
 
 namespace Core {
 
 static constexpr int NormalExitCode = 0;
 static constexpr int ErrorCode = -1;
+// Number of idle engines kept alive, one for the script and one for a sub-script run with `Utils.runScript`
+static constexpr int MaxPooledEngines = 2;
+
+namespace {
+
+/**
+ * Engine used to run scripts, it can be reused for multiple runs.
+ *
+ * All local files loaded by the engine are tracked with their last modification time, so the compiled units cached
+ * by the engine, and the components cached here, are invalidated when one of them changes.
+ *
+ * Javascript libraries (`.pragma library`) and modules are instantiated once per engine, and keep their state between
+ * runs: an engine which loaded one can't be reused.
+ */
+class ScriptEngine : public QQmlEngine, public QQmlAbstractUrlInterceptor
+{
+public:
+    explicit ScriptEngine(QObject *parent)
+        : QQmlEngine(parent)
+    {
+        addUrlInterceptor(this);
+    }
+    ~ScriptEngine() override { removeUrlInterceptor(this); }
+
+    // Called by the type loader, possibly in another thread
+    QUrl intercept(const QUrl &url, DataType type) override
+    {
+        if ((type == QmlFile || type == JavaScriptFile) && url.isLocalFile()) {
+            const QString fileName = url.toLocalFile();
+            QMutexLocker locker(&m_mutex);
+            if (!m_files.contains(fileName)) {
+                m_files.insert(fileName, QFileInfo(fileName).lastModified());
+                if (type == JavaScriptFile && isSharedScript(fileName))
+                    m_hasSharedScript = true;
+            }
+        }
+        return url;
+    }
+
+    bool hasSharedScript() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_hasSharedScript;
+    }
+
+    // Clears all cached components if one of the files loaded has changed since
+    void updateCache()
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            auto hasChanged = [this](const QString &fileName) {
+                return QFileInfo(fileName).lastModified() != m_files.value(fileName);
+            };
+            if (std::ranges::none_of(m_files.keys(), hasChanged))
+                return;
+            m_files.clear();
+        }
+        qDeleteAll(m_components);
+        m_components.clear();
+        clearComponentCache();
+    }
+
+    QQmlComponent *component(const QString &fileName) const { return m_components.value(fileName); }
+    void insertComponent(const QString &fileName, QQmlComponent *component) { m_components[fileName] = component; }
+
+private:
+    static bool isSharedScript(const QString &fileName)
+    {
+        if (fileName.endsWith(".mjs"))
+            return true;
+        QFile file(fileName);
+        return file.open(QIODevice::ReadOnly) && file.readAll().contains(".pragma library");
+    }
+
+    mutable QMutex m_mutex;
+    QHash<QString, QDateTime> m_files;
+    bool m_hasSharedScript = false;
+    QHash<QString, QQmlComponent *> m_components;
+};
+
+} // namespace
+
+// Returns the component for the script `fileName`, compiling it if it's not already cached by the engine.
+// A component that can't be compiled is not cached, and is owned by `parent`.
+static QQmlComponent *scriptComponent(const QString &fileName, QQmlEngine *engine, QObject *parent)
+{
+    auto scriptEngine = static_cast<ScriptEngine *>(engine);
+    if (auto component = scriptEngine->component(fileName))
+        return component;
+
+    auto component = new QQmlComponent(engine, engine);
+    if (QFileInfo(fileName).suffix() == "js") {
+        const QString text =
+            QStringLiteral(
+                "import QtQml\n"
+                "import Knut\n"
+                "import \"%1\" as MyScript\n"
+                "QtObject { property var _scriptResult; Component.onCompleted : _scriptResult = MyScript.main() }")
+                .arg(QUrl::fromLocalFile(fileName).toString());
+        component->setData(text.toLatin1(), QUrl::fromLocalFile(fileName));
+    } else {
+        component->loadUrl(QUrl::fromLocalFile(fileName));
+    }
+
+    if (component->isReady())
+        scriptEngine->insertComponent(fileName, component);
+    else
+        component->setParent(parent);
+    return component;
+}
 
 template <typename Object>
 void addProperties(QSet<QString> &properties)
@@ -61,6 +181,7 @@ ScriptRunner::ScriptRunner(QObject *parent)
     // Knut objects registrations
     qRegisterMetaType<FunctionArgument>();
     qRegisterMetaType<ClassSymbol>();
+    qRegisterMetaType<DocumentSnapshot>();
     qRegisterMetaType<FunctionSymbol>();
     qRegisterMetaType<QDirValueType>();
     qRegisterMetaType<QFileInfoValueType>();
@@ -97,11 +218,13 @@ ScriptRunner::ScriptRunner(QObject *parent)
     qmlRegisterUncreatableType<Document>("Knut", 1, 0, "Document", "Abstract class");
     qmlRegisterType<ScriptDialogItem>("Knut", 1, 0, "ScriptDialog");
     qmlRegisterType<ScriptItem>("Knut", 1, 0, "Script");
+    qmlRegisterUncreatableType<ScriptJob>("Knut", 1, 0, "ScriptJob", "Only created by Utils.runScriptAsync");
     qmlRegisterType<TextDocument>("Knut", 1, 0, "TextDocument");
     qmlRegisterType<QtUiDocument>("Knut", 1, 0, "QtUiDocument");
     qmlRegisterUncreatableType<QtUiWidget>("Knut", 1, 0, "QtUiWidget", "Only created by QtUiDocument");
     qmlRegisterType<CppDocument>("Knut", 1, 0, "CppDocument");
     qmlRegisterUncreatableType<Core::Symbol>("Knut", 1, 0, "Symbol", "Only created by CodeDocument");
+    qmlRegisterUncreatableType<QueryMatchIterator>("Knut", 1, 0, "QueryMatchIterator", "Only created by CodeDocument");
     qmlRegisterType<RcDocument>("Knut", 1, 0, "RcDocument");
     qmlRegisterType<QtTsDocument>("Knut", 1, 0, "QtTsDocument");
     qmlRegisterUncreatableType<QtTsMessage>("Knut", 1, 0, "QtTsMessage", "Only created by QtTsDocument");
@@ -142,6 +265,7 @@ ScriptRunner::ScriptRunner(QObject *parent)
     addProperties<ClassSymbol>(m_properties);
     addProperties<FunctionArgument>(m_properties);
     addProperties<FunctionSymbol>(m_properties);
+    addProperties<DocumentSnapshot>(m_properties);
     addProperties<QueryCapture>(m_properties);
     addProperties<QueryMatch>(m_properties);
     addProperties<Symbol>(m_properties);
@@ -167,6 +291,12 @@ ScriptRunner::ScriptRunner(QObject *parent)
     addProperties<Utils>(m_properties);
     addProperties<QDirValueType>(m_properties);
     addProperties<QFileInfoValueType>(m_properties);
+
+    // Pre-warm an engine, so the first script doesn't pay for the engine creation
+    QTimer::singleShot(0, this, [this]() {
+        if (m_enginePool.isEmpty())
+            m_enginePool.append(createEngine());
+    });
 }
 
 ScriptRunner::~ScriptRunner() = default;
@@ -185,16 +315,23 @@ QVariant ScriptRunner::runScript(const QString &fileName, nlohmann::json &&data,
         // TODO set the current project directory as the current path before running the script
 
         // Run the script
-        auto engine = getEngine(fullName);
+        auto engine = acquireEngine(fullName);
+        // All objects and connections specific to this run are attached to `run`, it is deleted when the script is
+        // finished, and the engine is then recycled
+        auto run = new QObject(this);
         if (endCallback)
-            connect(engine, &QObject::destroyed, this, endCallback);
+            connect(run, &QObject::destroyed, this, endCallback);
+        connect(run, &QObject::destroyed, this, [this, engine = QPointer<QQmlEngine>(engine)]() {
+            if (engine)
+                recycleEngine(engine);
+        });
 
         if (fi.suffix() == "js") {
-            result = runJavascript(fullName, engine);
+            result = runJavascript(fullName, engine, run);
         } else {
-            result = runQml(fullName, std::move(data), engine);
+            result = runQml(fullName, std::move(data), engine, run);
         }
-        // engine is deleted in runJavascript or runQml
+        // run is deleted in runJavascript or runQml
     } else {
         spdlog::error("{}: File {} doesn't exist", FUNCTION_NAME, fileName);
         return QVariant(ErrorCode);
@@ -203,6 +340,25 @@ QVariant ScriptRunner::runScript(const QString &fileName, nlohmann::json &&data,
     return result;
 }
 
+bool ScriptRunner::compileScript(const QString &fileName)
+{
+    const QString fullName = QFileInfo(fileName).absoluteFilePath();
+    auto engine = acquireEngine(fullName);
+
+    // Compiling the component is enough for the compiled units to be saved in the disk cache
+    QObject parent;
+    auto component = scriptComponent(fullName, engine, &parent);
+    const bool isReady = component->isReady();
+    if (!isReady) {
+        const auto errors = component->errors();
+        for (const auto &error : errors)
+            spdlog::error("{}({}): {}", error.url().toLocalFile(), error.line(), error.description());
+    }
+
+    recycleEngine(engine);
+    return isReady;
+}
+
 bool ScriptRunner::isProperty(const QString &apiCall)
 {
     return m_properties.contains(apiCall);
@@ -264,14 +420,9 @@ int ScriptRunner::callerLine(QObject *object, int frameIndex)
     return -1;
 }
 
-QQmlEngine *ScriptRunner::getEngine(const QString &fileName)
+QQmlEngine *ScriptRunner::createEngine()
 {
-    const QFileInfo fi(fileName);
-
-    auto engine = new QQmlEngine(this);
-    currentScriptPath = fi.absoluteFilePath();
-    engine->setProperty("scriptPath", fi.absolutePath());
-    engine->setProperty("scriptWindow", false);
+    auto engine = new ScriptEngine(this);
     engine->addImportPath("qrc:/qml");
 
     auto logWarnings = [this](const QList<QQmlError> &warnings) {
@@ -287,36 +438,86 @@ QQmlEngine *ScriptRunner::getEngine(const QString &fileName)
     connect(engine, &QQmlEngine::warnings, this, logWarnings);
     engine->setOutputWarningsToStandardError(false);
 
+    // QObject wrappers all share Object.prototype, so the QueryMatchIterator type can't have its own [Symbol.iterator]
+    // method: the getter only returns one for a QueryMatchIterator, other objects are still not iterable.
+    // Breaking out of a for...of loop calls return(), which releases the query.
+    const auto iterableSupport = engine->evaluate(QStringLiteral(R"JS(
+        Object.defineProperty(Object.prototype, Symbol.iterator, {
+            configurable: true,
+            get() {
+                if (typeof this !== "object" || !String(this).startsWith("Core::QueryMatchIterator("))
+                    return undefined;
+                return function() {
+                    const iterator = this;
+                    return {
+                        next() { return iterator.next(); },
+                        return(value) { iterator.close(); return {value: value, done: true}; },
+                        [Symbol.iterator]() { return this; }
+                    };
+                };
+            }
+        });
+    )JS"));
+    if (iterableSupport.isError())
+        spdlog::error("{}: can't install the iterator support: {}", FUNCTION_NAME, iterableSupport.toString());
+
+    // Resolve the imports used by all scripts once
+    QQmlComponent component(engine);
+    component.setData("import QtQml\nimport Knut\nQtObject {}", QUrl());
+
     return engine;
 }
 
-QVariant ScriptRunner::runJavascript(const QString &fileName, QQmlEngine *engine)
+QQmlEngine *ScriptRunner::acquireEngine(const QString &fileName)
 {
-    const QString text =
-        QStringLiteral(
-            "import QtQml\n"
-            "import Knut\n"
-            "import \"%1\" as MyScript\n"
-            "QtObject { property var _scriptResult; Component.onCompleted : _scriptResult = MyScript.main() }")
-            .arg(QUrl::fromLocalFile(fileName).toString());
+    const QFileInfo fi(fileName);
 
-    QQmlComponent component(engine);
-    component.setData(text.toLatin1(), QUrl::fromLocalFile(fileName));
+    auto engine = m_enginePool.isEmpty() ? createEngine() : m_enginePool.takeLast();
+    static_cast<ScriptEngine *>(engine)->updateCache();
 
-    auto *result = qobject_cast<QObject *>(component.create());
-    engine->deleteLater();
-    m_hasError = component.isError();
-    if (component.isReady() && !m_hasError)
+    // Reset the state of the previous run, singletons are created again when used
+    engine->clearSingletons();
+    currentScriptPath = fi.absoluteFilePath();
+    engine->setProperty("scriptPath", fi.absolutePath());
+    engine->setProperty("scriptWindow", false);
+    static const int dirTypeId = qmlTypeId("Knut", 1, 0, "Dir");
+    if (auto dir = engine->singletonInstance<Dir *>(dirTypeId))
+        dir->setCurrentScriptPath(fi.absolutePath());
+
+    return engine;
+}
+
+void ScriptRunner::recycleEngine(QQmlEngine *engine)
+{
+    // Engines used by visual scripts are tied to their windows, they can't be reused
+    if (engine->property("scriptWindow").toBool() || static_cast<ScriptEngine *>(engine)->hasSharedScript()
+        || m_enginePool.size() >= MaxPooledEngines) {
+        engine->deleteLater();
+        return;
+    }
+    engine->collectGarbage();
+    m_enginePool.append(engine);
+}
+
+QVariant ScriptRunner::runJavascript(const QString &fileName, QQmlEngine *engine, QObject *run)
+{
+    auto component = scriptComponent(fileName, engine, run);
+
+    auto *result = qobject_cast<QObject *>(component->create());
+    if (result)
+        result->setParent(run);
+    run->deleteLater();
+    m_hasError = component->isError();
+    if (component->isReady() && !m_hasError)
         return result->property("_scriptResult");
 
-    filterErrors(component);
+    filterErrors(*component);
     return QVariant(ErrorCode);
 }
 
-QVariant ScriptRunner::runQml(const QString &fileName, nlohmann::json &&data, QQmlEngine *engine)
+QVariant ScriptRunner::runQml(const QString &fileName, nlohmann::json &&data, QQmlEngine *engine, QObject *run)
 {
-    auto component = new QQmlComponent(engine, engine);
-    component->loadUrl(QUrl::fromLocalFile(fileName));
+    auto component = scriptComponent(fileName, engine, run);
 
     if (component->isReady()) {
         QObject *topLevel = component->create();
@@ -341,7 +542,7 @@ QVariant ScriptRunner::runQml(const QString &fileName, nlohmann::json &&data, QQ
                                      | Qt::WindowFullscreenButtonHint);
 
                 // Delete on close, and clean up the engine
-                connect(window, SIGNAL(closing(QQuickCloseEvent *)), engine,
+                connect(window, SIGNAL(closing(QQuickCloseEvent *)), run,
                         SLOT(deleteLater())); // clazy:excludeall=connect-not-normalized
 
                 window->show();
@@ -349,15 +550,15 @@ QVariant ScriptRunner::runQml(const QString &fileName, nlohmann::json &&data, QQ
                 engine->setProperty("scriptWindow", true);
                 dialog->initialize(std::move(data));
                 dialog->show();
-                connect(dialog, &ScriptDialogItem::scriptFinished, engine, &QObject::deleteLater);
+                connect(dialog, &ScriptDialogItem::scriptFinished, run, &QObject::deleteLater);
             }
             // Make sure calling `Qt.quit()` in QML deletes everything
-            auto cleanup = [engine, topLevel]() {
-                engine->deleteLater();
+            auto cleanup = [run, topLevel]() {
+                run->deleteLater();
                 if (topLevel)
                     topLevel->deleteLater();
             };
-            connect(engine, &QQmlEngine::quit, engine, cleanup);
+            connect(engine, &QQmlEngine::quit, run, cleanup);
 
             // Start the init function if it exists.
             if (topLevel->metaObject()->indexOfMethod("init()") != -1)
@@ -384,8 +585,10 @@ QVariant ScriptRunner::runQml(const QString &fileName, nlohmann::json &&data, QQ
             }
 
             // Cleanup scripts if not a visual one
-            if (!engine->property("scriptWindow").toBool())
-                engine->deleteLater();
+            if (!engine->property("scriptWindow").toBool()) {
+                topLevel->setParent(run);
+                run->deleteLater();
+            }
 
             if (m_hasError)
                 return ErrorCode;
@@ -401,7 +604,7 @@ QVariant ScriptRunner::runQml(const QString &fileName, nlohmann::json &&data, QQ
     // Error handling
     m_hasError = true;
     filterErrors(*component);
-    engine->deleteLater();
+    run->deleteLater();
     return ErrorCode;
 }
 
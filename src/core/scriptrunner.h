@@ -26,6 +26,9 @@ namespace Core {
  *
  * Provide a script engine and a way to run scripts.
  * The script engine is initialized with interfaces.
+ *
+ * Script engines are pooled: once a non-visual script is finished, its engine is reused for the next run, keeping
+ * the imports already resolved and the scripts already compiled.
  */
 class ScriptRunner : public QObject
 {
@@ -38,6 +41,8 @@ public:
     // Run a script
     using EndScriptFunc = std::function<void()>;
     QVariant runScript(const QString &fileName, nlohmann::json &&data, const EndScriptFunc &endCallback = {});
+    // Compile a script without running it, so it's stored in the disk cache
+    bool compileScript(const QString &fileName);
 
     bool hasError() const { return m_hasError; }
     QList<QQmlError> errors() const { return m_errors; }
@@ -51,9 +56,11 @@ public:
     static int callerLine(QObject *object, int frameIndex = 0);
 
 private:
-    QQmlEngine *getEngine(const QString &fileName);
-    QVariant runJavascript(const QString &fileName, QQmlEngine *engine);
-    QVariant runQml(const QString &fileName, nlohmann::json &&data, QQmlEngine *engine);
+    QQmlEngine *createEngine();
+    QQmlEngine *acquireEngine(const QString &fileName);
+    void recycleEngine(QQmlEngine *engine);
+    QVariant runJavascript(const QString &fileName, QQmlEngine *engine, QObject *run);
+    QVariant runQml(const QString &fileName, nlohmann::json &&data, QQmlEngine *engine, QObject *run);
     void filterErrors(const QQmlComponent &component);
 
 private:
@@ -62,6 +69,8 @@ private:
 
     bool m_hasError = false;
     QList<QQmlError> m_errors;
+    // Idle engines, ready to run a new script
+    QList<QQmlEngine *> m_enginePool;
 
     inline static QSet<QString> m_properties = {};
 };
@@ -12,7 +12,9 @@
 #include "logger.h"
 #include "rcdocument.h"
 #include "scriptmanager.h"
+#include "version.h"
 
+#include <QCryptographicHash>
 #include <QDir>
 #include <QFile>
 #include <QStandardPaths>
@@ -213,6 +215,24 @@ QString Settings::logFilePath() const
     return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/knut.log";
 }
 
+// Cached data is specific to a Knut version, each version has its own cache
+static QString versionedCachePath(const QString &name)
+{
+    const auto version =
+        QCryptographicHash::hash(core::knut_version().toUtf8(), QCryptographicHash::Sha1).toHex().left(12);
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + '/' + name + '/' + version;
+}
+
+QString Settings::scriptCachePath() const
+{
+    return versionedCachePath("scripts");
+}
+
+QString Settings::rcSnapshotCachePath() const
+{
+    return versionedCachePath("rc");
+}
+
 bool Settings::isTesting() const
 {
     return (m_mode == Mode::Test);
@@ -223,6 +243,12 @@ bool Settings::hasLsp() const
     return m_mode == Mode::Test || (m_mode == Mode::Gui && DEFAULT_VALUE(bool, EnableLSP));
 }
 
+bool Settings::hasUndo() const
+{
+    // Undo is never used when running a script from the command line
+    return m_mode != Mode::Cli;
+}
+
 void Settings::loadKnutSettings()
 {
     QFile file(":/core/settings.json");
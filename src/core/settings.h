@@ -49,10 +49,14 @@ public:
     static inline constexpr char RcAssetFlags[] = "/rc/asset_flags";
     static inline constexpr char RcAssetColors[] = "/rc/asset_transparent_colors";
     static inline constexpr char RcLanguageMap[] = "/rc/language_map";
+    static inline constexpr char RcSnapshotCache[] = "/rc/snapshot_cache";
     static inline constexpr char CppExcludedMacros[] = "/cpp/excluded_macros";
     static inline constexpr char SaveLogsToFile[] = "/logs/saveToFile";
+    static inline constexpr char HistoryLimit[] = "/logs/historyLimit";
     static inline constexpr char ScriptPaths[] = "/script_paths";
+    static inline constexpr char MaxConcurrentJobs[] = "/scripts/maxConcurrentJobs";
     static inline constexpr char Tab[] = "/text_editor/tab";
+    static inline constexpr char Undo[] = "/text_editor/undo";
     static inline constexpr char ToggleSection[] = "/toggle_section";
 
 public:
@@ -107,9 +111,12 @@ public:
     QString userFilePath() const;
     QString projectFilePath() const;
     QString logFilePath() const;
+    QString scriptCachePath() const;
+    QString rcSnapshotCachePath() const;
 
     bool isTesting() const;
     bool hasLsp() const;
+    bool hasUndo() const;
 
 public slots:
     bool setValue(const QString &path, const QJSValue &value);
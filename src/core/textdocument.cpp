@@ -25,7 +25,9 @@
 #include <QSignalBlocker>
 #include <QTextBlock>
 #include <QTextStream>
+#include <algorithm>
 #include <private/qwidgettextcontrol_p.h>
+#include <utility>
 
 namespace Core {
 
@@ -140,9 +142,12 @@ TextDocument::TextDocument(Type type, QObject *parent)
     connect(m_document, &QPlainTextEdit::textChanged, this, &TextDocument::textChanged);
     connect(m_document, &QPlainTextEdit::selectionChanged, this, &TextDocument::selectionChanged);
     connect(m_document, &QPlainTextEdit::cursorPositionChanged, this, &TextDocument::positionChanged);
-    connect(m_document->document(), &QTextDocument::contentsChange, this, [this]() {
-        setHasChanged(true);
-    });
+    connect(m_document->document(), &QTextDocument::contentsChange, this,
+            [this](int position, int charsRemoved, int charsAdded) {
+                Q_UNUSED(position)
+                setHasChanged(true);
+                updateUndoMemoryUsage(charsRemoved, charsAdded);
+            });
     m_document->installEventFilter(this);
 }
 
@@ -280,6 +285,9 @@ bool TextDocument::doLoad(const QString &fileName)
     m_document->setPlainText(text);
     setHasChanged(false);
 
+    // Setting the text resets the undo history
+    resetUndoHistory();
+
     return true;
 }
 
@@ -496,7 +504,10 @@ void TextDocument::undo(int count)
 {
     LOG_AND_MERGE(count);
     while (count != 0) {
-        m_document->undo();
+        if (!m_document->document()->isUndoAvailable() && !m_undoSnapshots.isEmpty())
+            restoreUndoSnapshot();
+        else
+            m_document->undo();
         --count;
     }
 }
@@ -514,6 +525,128 @@ void TextDocument::redo(int count)
     }
 }
 
+/**
+ * \brief Returns an estimation of the memory used by the undo history, in bytes
+ */
+qsizetype TextDocument::undoMemoryUsage() const
+{
+    return m_undoMemoryUsage;
+}
+
+/**
+ * \brief Sets the memory limit of the undo history, in bytes
+ *
+ * If the limit is exceeded, the undo history is compacted, see compactUndoHistory. A `limit` of -1 means there's no
+ * limit, and a `limit` of 0 disables the undo history completely.
+ */
+void TextDocument::setUndoMemoryLimit(qsizetype limit)
+{
+    m_undoMemoryLimit = limit;
+    m_document->setUndoRedoEnabled(limit != 0);
+    resetUndoHistory();
+}
+
+/**
+ * \brief Compacts the undo history into snapshots
+ *
+ * All the undo steps done since the last compaction are merged into one snapshot of the text, as it was before the
+ * first step. The redo history is lost.
+ *
+ * If the snapshots still exceed the memory limit, adjacent snapshots are merged, keeping the oldest and the most
+ * recent ones, and as a last resort the history is dropped.
+ */
+void TextDocument::compactUndoHistory()
+{
+    auto document = m_document->document();
+    if (!document->isUndoRedoEnabled())
+        return;
+
+    if (document->isUndoAvailable()) {
+        // Only the undo stack knows the text before the first step: undo all steps to get it, and then set the current
+        // text back in one change outside of the history.
+        const QString text = document->toPlainText();
+        const int position = m_document->textCursor().position();
+        while (document->isUndoAvailable())
+            document->undo();
+        m_undoSnapshots.push_back(document->toPlainText());
+        setTextOutsideUndoHistory(text);
+        QTextCursor cursor(document);
+        cursor.setPosition(std::min(position, static_cast<int>(text.size())));
+        m_document->setTextCursor(cursor);
+    }
+    document->clearUndoRedoStacks();
+
+    while (m_undoMemoryLimit >= 0 && undoSnapshotsUsage() > m_undoMemoryLimit && !m_undoSnapshots.isEmpty())
+        m_undoSnapshots.removeAt(m_undoSnapshots.size() > 2 ? 1 : m_undoSnapshots.size() - 1);
+    setUndoMemoryUsage(undoSnapshotsUsage());
+}
+
+void TextDocument::updateUndoMemoryUsage(int charsRemoved, int charsAdded)
+{
+    // Undoing a change only moves it to the redo stack
+    auto document = m_document->document();
+    if (!document->isUndoRedoEnabled() || document->isRedoAvailable())
+        return;
+
+    // This is an estimation, the undo history keeps the text removed and added, and one command per change
+    constexpr int UndoCommandSize = 64;
+    setUndoMemoryUsage(m_undoMemoryUsage + (charsRemoved + charsAdded) * sizeof(QChar) + UndoCommandSize);
+
+    // The document is still being edited when contentsChange is emitted, the compaction changes the text and the undo
+    // stack, so it's done later
+    if (m_isUndoCompactionPending || m_undoMemoryLimit <= 0 || m_undoMemoryUsage <= m_undoMemoryLimit)
+        return;
+    m_isUndoCompactionPending = true;
+    QMetaObject::invokeMethod(
+        this,
+        [this]() {
+            m_isUndoCompactionPending = false;
+            if (m_undoMemoryLimit > 0 && m_undoMemoryUsage > m_undoMemoryLimit)
+                compactUndoHistory();
+        },
+        Qt::QueuedConnection);
+}
+
+void TextDocument::setUndoMemoryUsage(qsizetype usage)
+{
+    if (m_undoMemoryUsage == usage)
+        return;
+    const auto oldUsage = std::exchange(m_undoMemoryUsage, usage);
+    emit undoMemoryUsageChanged(usage, oldUsage);
+}
+
+void TextDocument::resetUndoHistory()
+{
+    m_undoSnapshots.clear();
+    setUndoMemoryUsage(0);
+}
+
+void TextDocument::restoreUndoSnapshot()
+{
+    Q_ASSERT(!m_undoSnapshots.isEmpty());
+
+    // Restoring the snapshot is one step of the undo history, it can't be redone
+    setTextOutsideUndoHistory(m_undoSnapshots.takeLast());
+    setUndoMemoryUsage(undoSnapshotsUsage());
+}
+
+void TextDocument::setTextOutsideUndoHistory(const QString &text)
+{
+    m_document->setUndoRedoEnabled(false);
+    QTextCursor cursor(m_document->document());
+    cursor.select(QTextCursor::Document);
+    cursor.insertText(text);
+    m_document->setUndoRedoEnabled(true);
+}
+
+qsizetype TextDocument::undoSnapshotsUsage() const
+{
+    qsizetype usage = 0;
+    for (const auto &snapshot : m_undoSnapshots)
+        usage += snapshot.size() * sizeof(QChar);
+    return usage;
+}
+
 void TextDocument::movePosition(QTextCursor::MoveOperation operation, QTextCursor::MoveMode mode, int count)
 {
     auto cursor = m_document->textCursor();
@@ -1539,22 +1672,34 @@ static QString indentToString(int indentSize, const TabSettings &settings)
     return settings.insertSpaces ? QString(indentSize * settings.tabSize, ' ') : QString(indentSize, '\t');
 }
 
-static int indentOneLine(QTextCursor &cursor, int tabCount, const TabSettings &settings, bool relative)
+struct IndentationEdit
 {
-    QString text = cursor.selectedText();
-    cursor.removeSelectedText();
+    int position; // start of the line
+    int length; // length of the existing indentation
+    QString indentation; // new indentation
+};
 
-    const int oldSize = text.size();
-    const int firstChar = firstNonSpace(text);
-    const int startColumn = columnAt(text, firstChar, settings.tabSize);
-    const int currentIndent = startColumn / settings.tabSize;
-    const int indentSize = qMax(relative ? (currentIndent + tabCount) : tabCount, 0);
+// Computes the new indentation of all lines between blockStart and blockEnd in one pass over the text.
+// Lines already having the right indentation are skipped.
+static QList<IndentationEdit> computeIndentation(const QTextDocument *document, int blockStart, int blockEnd,
+                                                 int tabCount, const TabSettings &settings, bool relative)
+{
+    QList<IndentationEdit> edits;
+    edits.reserve(blockEnd - blockStart + 1);
 
-    text.remove(0, firstChar);
-    text = indentToString(indentSize, settings) + text;
+    QTextBlock block = document->findBlockByNumber(blockStart);
+    for (int blockNumber = blockStart; blockNumber <= blockEnd && block.isValid(); ++blockNumber) {
+        const QString text = block.text();
+        const int firstChar = firstNonSpace(text);
+        const int currentIndent = columnAt(text, firstChar, settings.tabSize) / settings.tabSize;
+        const int indentSize = qMax(relative ? (currentIndent + tabCount) : tabCount, 0);
 
-    cursor.insertText(text);
-    return text.size() - oldSize;
+        QString indentation = indentToString(indentSize, settings);
+        if (QStringView(text).first(firstChar) != indentation)
+            edits.push_back({block.position(), firstChar, std::move(indentation)});
+        block = block.next();
+    }
+    return edits;
 }
 
 static void indentBlocksInTextEdit(QPlainTextEdit *textEdit, int blockStart, int blockEnd, int tabCount, bool relative)
@@ -1567,27 +1712,27 @@ static void indentBlocksInTextEdit(QPlainTextEdit *textEdit, int blockStart, int
     int newStart = cursor.selectionStart();
     int newEnd = cursor.selectionEnd();
 
-    // Move the position to the beginning of the first line
-    cursor.setPosition(textEdit->document()->findBlockByNumber(blockStart).position());
-
-    cursor.beginEditBlock();
-    // Iterate through all line, and change the indentation
-    for (int block = blockStart; block <= blockEnd; ++block) {
-        cursor.select(QTextCursor::LineUnderCursor);
-        // We need to update the new selection if we're doing modifications at or before the selection.
-        const auto updateStart = cursor.selectionStart() <= newStart;
-        const auto updateEnd = cursor.selectionStart() <= newEnd;
-
-        const int delta = indentOneLine(cursor, tabCount, settings, relative);
+    const auto edits = computeIndentation(textEdit->document(), blockStart, blockEnd, tabCount, settings, relative);
+    if (edits.isEmpty())
+        return;
 
-        // update the position of the selection, depending on how much text was added/removed
-        if (updateStart) {
+    // We need to update the new selection if we're doing modifications at or before the selection.
+    const int oldStart = newStart;
+    const int oldEnd = newEnd;
+    for (const auto &edit : edits) {
+        const int delta = static_cast<int>(edit.indentation.size()) - edit.length;
+        if (edit.position <= oldStart)
             newStart += delta;
-        }
-        if (updateEnd) {
+        if (edit.position <= oldEnd)
             newEnd += delta;
-        }
-        cursor.movePosition(QTextCursor::Down, QTextCursor::MoveAnchor);
+    }
+
+    // Apply all changes as one edit, starting from the end so the positions stay valid
+    cursor.beginEditBlock();
+    for (auto it = edits.crbegin(); it != edits.crend(); ++it) {
+        cursor.setPosition(it->position);
+        cursor.setPosition(it->position + it->length, QTextCursor::KeepAnchor);
+        cursor.insertText(it->indentation);
     }
     cursor.endEditBlock();
 
@@ -16,6 +16,7 @@
 
 #include <QPointer>
 #include <QRegularExpressionMatch>
+#include <QStringList>
 #include <QTextCursor>
 #include <QTextDocument>
 
@@ -91,6 +92,10 @@ public:
 
     QString tab() const;
 
+    qsizetype undoMemoryUsage() const;
+    void setUndoMemoryLimit(qsizetype limit);
+    void compactUndoHistory();
+
 public slots:
     void setPosition(int newPosition);
     void setText(const QString &newText);
@@ -204,6 +209,7 @@ signals:
     void textChanged();
     void selectionChanged();
     void lineEndingChanged();
+    void undoMemoryUsageChanged(qsizetype usage, qsizetype oldUsage);
 
 protected:
     explicit TextDocument(Type type, QObject *parent = nullptr);
@@ -222,6 +228,12 @@ protected:
 
 private:
     void detectFormat(const QByteArray &data);
+    void updateUndoMemoryUsage(int charsRemoved, int charsAdded);
+    void setUndoMemoryUsage(qsizetype usage);
+    void resetUndoHistory();
+    void restoreUndoSnapshot();
+    void setTextOutsideUndoHistory(const QString &text);
+    qsizetype undoSnapshotsUsage() const;
 
     void movePosition(QTextCursor::MoveOperation operation, QTextCursor::MoveMode mode = QTextCursor::MoveAnchor,
                       int count = 1);
@@ -238,6 +250,13 @@ private:
     QPointer<QPlainTextEdit> m_document;
     LineEnding m_lineEnding = NativeLineEnding;
     bool m_utf8Bom = false;
+
+    // Undo history memory management, all sizes are in bytes (-1 means no limit)
+    qsizetype m_undoMemoryUsage = 0;
+    qsizetype m_undoMemoryLimit = -1;
+    // Texts restored by undo once the QTextDocument undo stack is empty, created when compacting the history
+    QStringList m_undoSnapshots;
+    bool m_isUndoCompactionPending = false;
 };
 
 } // namespace Core
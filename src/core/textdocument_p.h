@@ -25,6 +25,15 @@ struct TabSettings
 
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(TabSettings, insertSpaces, tabSize);
 
+//! Store undo memory limits for text documents, in MB (-1 means no limit)
+struct UndoSettings
+{
+    int documentLimit = 32;
+    int projectLimit = 256;
+};
+
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(UndoSettings, documentLimit, projectLimit);
+
 void indentTextInTextEdit(QPlainTextEdit *textEdit, int tabCount, bool relative = true);
 void gotoLineInTextEdit(QPlainTextEdit *textEdit, int line, int column = 1);
 
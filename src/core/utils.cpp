@@ -18,6 +18,7 @@
 #include <QDir>
 #include <QElapsedTimer>
 #include <QFileInfo>
+#include <QJSEngine>
 #include <QTemporaryFile>
 
 namespace Core {
@@ -114,6 +115,23 @@ void Utils::runScript(const QString &path, bool log)
     ScriptManager::instance()->runScript(path, nlohmann::json::object(), false, log);
 }
 
+/*!
+ * \qmlmethod ScriptJob Utils::runScriptAsync(string path, int priority = ScriptJob.Normal)
+ * Queues the script given by `path`, and returns the job running it. The script is run once the current script is
+ * done, and all jobs with a higher or equal `priority` are started.
+ *
+ * ```js
+ * Utils.runScriptAsync("path/to/script.js").then(result => Message.log("Result: " + result));
+ * ```
+ */
+Core::ScriptJob *Utils::runScriptAsync(const QString &path, int priority)
+{
+    LOG(path, priority);
+
+    // The job is kept alive by the script once done, see ScriptManager::releaseJob
+    return ScriptManager::instance()->runScriptAsync(path, nlohmann::json::object(), priority, true, qjsEngine(this));
+}
+
 /*!
  * \qmlmethod Utils::sleep(int msecs)
  * Sleeps for `msecs` milliseconds.
@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include "scriptjob.h"
 #include "utils/string_helper.h"
 
 #include <QHash>
@@ -43,6 +44,8 @@ public slots:
 
     static void addScriptPath(const QString &path);
     static void runScript(const QString &path, bool log = false);
+    // Not static: the job is bound to the engine running the calling script
+    Core::ScriptJob *runScriptAsync(const QString &path, int priority = ScriptJob::Normal);
 
     static void sleep(int msecs);
 
@@ -38,6 +38,13 @@ HistoryPanel::HistoryPanel(QWidget *parent)
     };
     connect(m_model, &QAbstractItemModel::rowsInserted, this, showLast);
 
+    // Old calls are removed from the history when the limit is reached, keep the recording start in sync
+    auto updateStartRow = [this](const QModelIndex &, int first, int last) {
+        if (isRecording())
+            m_startRow = std::max(0, m_startRow - (last - first + 1));
+    };
+    connect(m_model, &QAbstractItemModel::rowsAboutToBeRemoved, this, updateStartRow);
+
     auto layout = new QHBoxLayout(m_toolBar);
     layout->setContentsMargins({});
 
@@ -0,0 +1,111 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "profilerpanel.h"
+#include "core/profiler.h"
+#include "guisettings.h"
+
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QSortFilterProxyModel>
+#include <QTimer>
+#include <QToolButton>
+
+namespace Gui {
+
+// Refresh rate of the statistics while profiling
+static constexpr int RefreshInterval = 500;
+
+ProfilerPanel::ProfilerPanel(QWidget *parent)
+    : QTreeView(parent)
+    , m_toolBar(new QWidget)
+    , m_profileButton(new QToolButton(m_toolBar))
+    , m_model(new Core::ProfilerModel(this))
+    , m_refreshTimer(new QTimer(this))
+{
+    setWindowTitle(tr("Profiler"));
+    setObjectName("ProfilerPanel");
+    setUniformRowHeights(true);
+    setRootIsDecorated(false);
+
+    auto proxyModel = new QSortFilterProxyModel(this);
+    proxyModel->setSourceModel(m_model);
+    proxyModel->setSortRole(Qt::UserRole);
+    setModel(proxyModel);
+    setSortingEnabled(true);
+    sortByColumn(Core::ProfilerModel::TotalCol, Qt::DescendingOrder);
+    header()->setSectionResizeMode(Core::ProfilerModel::NameCol, QHeaderView::Stretch);
+    header()->setStretchLastSection(false);
+
+    m_refreshTimer->setInterval(RefreshInterval);
+    connect(m_refreshTimer, &QTimer::timeout, m_model, &Core::ProfilerModel::refresh);
+
+    auto layout = new QHBoxLayout(m_toolBar);
+    layout->setContentsMargins({});
+
+    GuiSettings::setIcon(m_profileButton, ":/gui/play.png");
+    m_profileButton->setToolTip(tr("Profile API calls"));
+    m_profileButton->setCheckable(true);
+    m_profileButton->setChecked(Core::Profiler::isEnabled());
+    m_profileButton->setAutoRaise(true);
+    layout->addWidget(m_profileButton);
+    connect(m_profileButton, &QToolButton::toggled, this, &ProfilerPanel::setProfiling);
+
+    auto clearButton = new QToolButton(m_toolBar);
+    GuiSettings::setIcon(clearButton, ":/gui/delete-sweep.png");
+    clearButton->setToolTip(tr("Clear"));
+    clearButton->setAutoRaise(true);
+    layout->addWidget(clearButton);
+    connect(clearButton, &QToolButton::clicked, this, &ProfilerPanel::clear);
+
+    auto saveButton = new QToolButton(m_toolBar);
+    GuiSettings::setIcon(saveButton, ":/gui/content-save.png");
+    saveButton->setToolTip(tr("Save Trace..."));
+    saveButton->setAutoRaise(true);
+    layout->addWidget(saveButton);
+    connect(saveButton, &QToolButton::clicked, this, &ProfilerPanel::saveTrace);
+
+    // Profiling may have been started with the --profile option
+    if (Core::Profiler::isEnabled())
+        m_refreshTimer->start();
+}
+
+QWidget *ProfilerPanel::toolBar() const
+{
+    return m_toolBar;
+}
+
+void ProfilerPanel::setProfiling(bool profiling)
+{
+    Core::Profiler::setEnabled(profiling);
+    if (profiling) {
+        m_refreshTimer->start();
+    } else {
+        m_refreshTimer->stop();
+        m_model->refresh();
+    }
+}
+
+void ProfilerPanel::clear()
+{
+    Core::Profiler::clear();
+    m_model->refresh();
+}
+
+void ProfilerPanel::saveTrace()
+{
+    const QString fileName =
+        QFileDialog::getSaveFileName(this, tr("Save Trace"), "profile.json", tr("Chrome trace (*.json)"));
+    if (!fileName.isEmpty())
+        Core::Profiler::writeTrace(fileName);
+}
+
+} // namespace Gui
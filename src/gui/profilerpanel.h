@@ -0,0 +1,43 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <QTreeView>
+
+class QTimer;
+class QToolButton;
+
+namespace Core {
+class ProfilerModel;
+}
+
+namespace Gui {
+
+class ProfilerPanel : public QTreeView
+{
+    Q_OBJECT
+public:
+    explicit ProfilerPanel(QWidget *parent = nullptr);
+
+    QWidget *toolBar() const;
+
+private:
+    void setProfiling(bool profiling);
+    void clear();
+    void saveTrace();
+
+    QWidget *const m_toolBar = nullptr;
+    QToolButton *const m_profileButton = nullptr;
+    Core::ProfilerModel *const m_model = nullptr;
+    QTimer *const m_refreshTimer = nullptr;
+};
+
+} // namespace Gui
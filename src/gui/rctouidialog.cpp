@@ -82,17 +82,16 @@ void RcToUiDialog::accept()
         return;
     }
 
+    QStringList ids;
     const int numberOfDialogs = ui->idList->count();
     for (int i = 0; i < numberOfDialogs; ++i) {
         QListWidgetItem *item = ui->idList->item(i);
-        if (item->checkState() == Qt::Checked) {
-            const auto &dialog = m_document->dialog(item->text(), flags, scaleX, scaleY);
-            const QString fileName = path + '/' + dialog.id + ".ui";
-            if (!m_document->writeDialogToUi(dialog, fileName)) {
-                QMessageBox::warning(nullptr, tr("Error"), tr("Unable to write ui file %1.").arg(fileName));
-                return;
-            }
-        }
+        if (item->checkState() == Qt::Checked)
+            ids.push_back(item->text());
+    }
+    if (!ids.isEmpty() && !m_document->writeDialogsToUi(ids, path, flags, scaleX, scaleY)) {
+        QMessageBox::warning(nullptr, tr("Error"), tr("Unable to write ui files in %1.").arg(path));
+        return;
     }
     QDialog::accept();
 }
@@ -102,10 +102,6 @@ ShortcutManager::ShortcutManager(MainWindow *parent)
     // Defer initialization, so actions are created
     QTimer::singleShot(0, this, &ShortcutManager::initialize);
 
-    auto addScript = [this](const Script &script) {
-        m_commands.emplace_back(script);
-    };
-    connect(Core::ScriptManager::instance(), &Core::ScriptManager::scriptAdded, this, addScript);
     auto removeScript = [this](const Script &script) {
         std::erase_if(m_commands, [this, &script](const auto &command) {
             return ShortcutManager::id(command) == script.name;
@@ -167,6 +163,15 @@ void ShortcutManager::initialize()
     for (const auto &script : scripts)
         m_commands.emplace_back(script);
 
+    // Scripts are loaded in the background, and may be added after the initialization
+    auto addScript = [this](const Script &script) {
+        m_commands.emplace_back(script);
+        const auto &command = m_commands.back();
+        if (auto shortcut = GuiSettings::instance()->shortcuts().value(id(command)); !shortcut.isEmpty())
+            setShortcut(command, QKeySequence(shortcut));
+    };
+    connect(Core::ScriptManager::instance(), &Core::ScriptManager::scriptAdded, this, addScript);
+
     // Restore shortcuts
     auto shortcuts = GuiSettings::instance()->shortcuts();
     if (shortcuts.isEmpty())
@@ -24,9 +24,13 @@
 #include <QMessageBox>
 #include <QPalette>
 #include <QTextEdit>
+#include <QtConcurrent/QtConcurrentRun>
 
 namespace Gui {
 
+// Delay in ms after the last change of the document before parsing it again
+static constexpr int ParseDelay = 250;
+
 QueryErrorHighlighter::QueryErrorHighlighter(QTextDocument *parent)
     : KSyntaxHighlighting::SyntaxHighlighter(parent)
 {
@@ -87,7 +91,6 @@ void QueryErrorHighlighter::setUtf8Position(int position)
 TreeSitterInspector::TreeSitterInspector(QWidget *parent)
     : QDialog(parent)
     , ui(new Ui::TreeSitterInspector)
-    , m_parser(nullptr)
     , m_errorHighlighter(nullptr)
     , m_document(nullptr)
 {
@@ -128,6 +131,13 @@ TreeSitterInspector::TreeSitterInspector(QWidget *parent)
 
     connect(ui->enableUnnamed, &QCheckBox::toggled, this, &TreeSitterInspector::showUnnamedChanged);
 
+    // Wait for the user to stop typing before parsing the document again
+    m_parseTimer.setSingleShot(true);
+    m_parseTimer.setInterval(ParseDelay);
+    connect(&m_parseTimer, &QTimer::timeout, this, &TreeSitterInspector::parseText);
+    connect(&m_parseWatcher, &QFutureWatcher<std::shared_ptr<ParseResult>>::finished, this,
+            &TreeSitterInspector::applyParsedText);
+
     // Set a 2/3 - 1/3 repartition for the views
     ui->splitter->setStretchFactor(0, 2);
     ui->splitter->setStretchFactor(1, 1);
@@ -248,20 +258,61 @@ void TreeSitterInspector::showUnnamedChanged()
 {
     // technically the text didn't change, but this will force
     // a complete re-parse and re-build of the entire tree.
-    changeText();
+    m_parsedText.clear();
+    parseText();
 }
 
 void TreeSitterInspector::changeText()
 {
+    ++m_revision;
+    m_parseTimer.start();
+}
+
+void TreeSitterInspector::parseText()
+{
+    m_parseTimer.stop();
+    if (!m_document)
+        return;
+    // Only one parse at a time, the next one is started once the current one is done
+    if (m_parseWatcher.isRunning())
+        return;
+
     QString text;
     {
         Core::LoggerDisabler disableLogging;
         text = m_document->text();
     }
-    m_parser.setIncludedRanges(m_document->includedRanges());
-    auto tree = m_parser.parseString(text);
-    if (tree.has_value()) {
-        m_treemodel.setTree(std::move(tree.value()), makePredicates(), ui->enableUnnamed->isChecked());
+    // Nothing to do if the text is the same as the one already shown, like after an undo/redo
+    if (!m_parsedText.isNull() && text == m_parsedText)
+        return;
+
+    auto language = treesitter::Parser::getLanguage(m_document->type());
+    auto ranges = m_document->includedRanges();
+    const int revision = m_revision;
+    m_parseWatcher.setFuture(QtConcurrent::run([language, ranges, revision, text]() {
+        treesitter::Parser parser(language);
+        parser.setIncludedRanges(ranges);
+        auto tree = parser.parseString(text);
+        return std::make_shared<ParseResult>(
+            ParseResult {.revision = revision, .text = text, .tree = std::move(tree)});
+    }));
+}
+
+void TreeSitterInspector::applyParsedText()
+{
+    auto result = m_parseWatcher.result();
+    if (!m_document)
+        return;
+    // The text has changed while parsing: parse again, once the user stops typing
+    if (result->revision != m_revision) {
+        m_parseTimer.start();
+        return;
+    }
+
+    m_parsedText = result->text;
+    if (result->tree.has_value()) {
+        m_treemodel.setTree(std::move(result->tree.value()), std::make_unique<treesitter::Predicates>(result->text),
+                            ui->enableUnnamed->isChecked());
         ui->treeInspector->expandAll();
         for (int i = 0; i < 2; i++) {
             ui->treeInspector->resizeColumnToContents(i);
@@ -289,15 +340,16 @@ void TreeSitterInspector::setDocument(Core::CodeDocument *document)
     }
 
     m_document = document;
+    ++m_revision;
+    m_parsedText.clear();
     if (m_document) {
-        m_parser = treesitter::Parser::getLanguage(document->type());
         connect(m_document, &Core::CodeDocument::textChanged, this, &TreeSitterInspector::changeText);
         connect(m_document, &Core::CodeDocument::positionChanged, this, &TreeSitterInspector::changeCursor);
 
         changeCursor();
-        changeText();
+        parseText();
     } else {
-        m_parser = {nullptr};
+        m_parseTimer.stop();
         m_treemodel.clear();
     }
 }
@@ -325,9 +377,8 @@ QString TreeSitterInspector::highlightQueryError(const treesitter::Query::Error
 std::unique_ptr<treesitter::Predicates> TreeSitterInspector::makePredicates()
 {
     if (m_document) {
-        // No need to always log the call to TextDocument::text
-        Core::LoggerDisabler disabler;
-        return std::make_unique<treesitter::Predicates>(m_document->text());
+        // Use the text of the current tree, the document may have changed since it was parsed
+        return std::make_unique<treesitter::Predicates>(m_parsedText);
     } else {
         return nullptr;
     }
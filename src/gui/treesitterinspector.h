@@ -15,7 +15,10 @@
 
 #include <KSyntaxHighlighting/SyntaxHighlighter>
 #include <QDialog>
+#include <QFutureWatcher>
 #include <QSyntaxHighlighter>
+#include <QTimer>
+#include <memory>
 
 namespace treesitter {
 class Predicates;
@@ -61,6 +64,8 @@ private:
     void changeCurrentDocument(Core::Document *document);
     void setDocument(Core::CodeDocument *document);
     void changeText();
+    void parseText();
+    void applyParsedText();
     void changeCursor();
     void changeQuery();
     void changeQueryState();
@@ -75,7 +80,19 @@ private:
 
     Ui::TreeSitterInspector *ui;
 
-    treesitter::Parser m_parser;
+    // The document is parsed in a background thread, once the user stops typing.
+    struct ParseResult
+    {
+        int revision;
+        QString text;
+        std::optional<treesitter::Tree> tree;
+    };
+    QTimer m_parseTimer;
+    QFutureWatcher<std::shared_ptr<ParseResult>> m_parseWatcher;
+    // Incremented each time the text changes, results of older revisions are discarded
+    int m_revision = 0;
+    QString m_parsedText;
+
     TreeSitterTreeModel m_treemodel;
     QueryErrorHighlighter *m_errorHighlighter;
 
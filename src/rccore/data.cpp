@@ -227,49 +227,105 @@ bool operator==(const ToolBarItem &left, const ToolBarItem &right)
 }
 
 template <typename T>
-const T *findById(const QList<T> &collection, const QString &id)
+void updateIndex(const QList<T> &collection, Data::IdIndex &index)
 {
+    index.indexes.clear();
+    index.indexes.reserve(collection.size());
+    // Iterate backward, so the index of the first item is kept if there are duplicated ids
+    for (qsizetype i = collection.size() - 1; i >= 0; --i)
+        index.indexes.insert(collection.at(i).id, i);
+    index.count = collection.size();
+}
+
+template <typename T>
+const T *findById(const QList<T> &collection, const Data::IdIndex &index, const QString &id)
+{
+    // Fast path, the index is up to date
+    if (index.count == collection.size()) {
+        const qsizetype i = index.indexes.value(id, -1);
+        if (i == -1)
+            return nullptr;
+        if (collection.at(i).id == id)
+            return &collection.at(i);
+    }
+
+    // The list has been changed without calling updateIndexes: do a linear search.
+    // The index is not rebuilt here, the accessors are const and may be called from multiple threads.
     auto it = std::find_if(collection.cbegin(), collection.cend(), [id](const auto &data) {
         return data.id == id;
     });
-    if (it == collection.cend())
-        return nullptr;
-    return &*it;
+    return it == collection.cend() ? nullptr : &*it;
 }
 
 const Asset *Data::asset(const QString &id) const
 {
-    return findById(assets, id);
+    return findById(assets, assetIndex, id);
 }
 
 const ToolBar *Data::toolBar(const QString &id) const
 {
-    return findById(toolBars, id);
+    return findById(toolBars, toolBarIndex, id);
 }
 
 const Data::Dialog *Data::dialog(const QString &id) const
 {
-    return findById(dialogs, id);
+    return findById(dialogs, dialogIndex, id);
 }
 
 const Data::DialogData *Data::dialogData(const QString &id) const
 {
-    return findById(dialogDataList, id);
+    return findById(dialogDataList, dialogDataIndex, id);
 }
 
 const Menu *Data::menu(const QString &id) const
 {
-    return findById(menus, id);
+    return findById(menus, menuIndex, id);
 }
 
 const Data::AcceleratorTable *Data::acceleratorTable(const QString &id) const
 {
-    return findById(acceleratorTables, id);
+    return findById(acceleratorTables, acceleratorTableIndex, id);
 }
 
 const Ribbon *Data::ribbon(const QString &id) const
 {
-    return findById(ribbons, id);
+    return findById(ribbons, ribbonIndex, id);
+}
+
+template <typename T>
+void appendList(QList<T> &list, QList<T> &&other)
+{
+    if (list.isEmpty())
+        list = std::move(other);
+    else
+        list.append(std::move(other));
+}
+
+void Data::append(Data &&other)
+{
+    appendList(icons, std::move(other.icons));
+    appendList(assets, std::move(other.assets));
+    appendList(acceleratorTables, std::move(other.acceleratorTables));
+    appendList(menus, std::move(other.menus));
+    appendList(toolBars, std::move(other.toolBars));
+    appendList(dialogDataList, std::move(other.dialogDataList));
+    appendList(dialogs, std::move(other.dialogs));
+    appendList(ribbons, std::move(other.ribbons));
+    if (strings.isEmpty())
+        strings = std::move(other.strings);
+    else
+        strings.insert(other.strings);
+}
+
+void Data::updateIndexes()
+{
+    updateIndex(assets, assetIndex);
+    updateIndex(toolBars, toolBarIndex);
+    updateIndex(dialogs, dialogIndex);
+    updateIndex(dialogDataList, dialogDataIndex);
+    updateIndex(menus, menuIndex);
+    updateIndex(acceleratorTables, acceleratorTableIndex);
+    updateIndex(ribbons, ribbonIndex);
 }
 
 bool operator==(const Widget &left, const Widget &right)
@@ -287,6 +287,27 @@ struct Data
     const Menu *menu(const QString &id) const;
     const AcceleratorTable *acceleratorTable(const QString &id) const;
     const Ribbon *ribbon(const QString &id) const;
+
+    // Map an id to the index of the first item with this id in the list
+    // The index is only used if its size matches the list, otherwise the accessors do a linear search
+    struct IdIndex
+    {
+        QHash<QString, qsizetype> indexes;
+        qsizetype count = -1;
+    };
+    // Internal data, used by the accessors: call updateIndexes each time the lists are changed
+    IdIndex assetIndex;
+    IdIndex toolBarIndex;
+    IdIndex dialogIndex;
+    IdIndex dialogDataIndex;
+    IdIndex menuIndex;
+    IdIndex acceleratorTableIndex;
+    IdIndex ribbonIndex;
+
+    void updateIndexes();
+
+    // Move all resources of `other` at the end of this data
+    void append(Data &&other);
 };
 
 } // namespace RcCore
@@ -12,110 +12,194 @@
 #include "utils/log.h"
 
 #include <QDir>
-#include <QHash>
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+using namespace Qt::Literals::StringLiterals;
 
 namespace RcCore {
 
-#define COMMA ,
+namespace {
+struct KeywordEntry
+{
+    std::string_view name;
+    Keywords keyword;
+};
+}
+
 // clang-format off
-Q_GLOBAL_STATIC_WITH_ARGS(QHash<QString COMMA Keywords>, KeywordMap, {
+constexpr std::array KeywordTable = {
     // Used in MENUITEM - not handled in Qt
-    {"ACCELERATORS" COMMA Keywords::ACCELERATORS} COMMA
-    {"AFX_DIALOG_LAYOUT" COMMA Keywords::AFX_DIALOG_LAYOUT} COMMA
-    {"BITMAP" COMMA Keywords::BITMAP} COMMA
-    {"CURSOR" COMMA Keywords::CURSOR} COMMA
-    {"DESIGNINFO" COMMA Keywords::DESIGNINFO} COMMA
-    {"DIALOG" COMMA Keywords::DIALOG} COMMA
-    {"DIALOGEX" COMMA Keywords::DIALOGEX} COMMA
-    {"DLGINIT" COMMA Keywords::DLGINIT} COMMA
-    {"FONT" COMMA Keywords::FONT} COMMA
-    {"HTML" COMMA Keywords::HTML} COMMA
-    {"ICON" COMMA Keywords::ICON} COMMA
-    {"IMAGE" COMMA Keywords::IMAGE} COMMA
-    {"MENU" COMMA Keywords::MENU} COMMA
-    {"MENUEX" COMMA Keywords::MENUEX} COMMA
-    {"MESSAGETABLE" COMMA Keywords::MESSAGETABLE} COMMA
-    {"PNG" COMMA Keywords::PNG} COMMA
-    {"POPUP" COMMA Keywords::POPUP} COMMA
-    {"RCDATA" COMMA Keywords::RCDATA} COMMA
-    {"REGISTRY" COMMA Keywords::REGISTRY} COMMA
-    {"STRINGTABLE" COMMA Keywords::STRINGTABLE} COMMA
-    {"TEXTINCLUDE" COMMA Keywords::TEXTINCLUDE} COMMA
-    {"TOOLBAR" COMMA Keywords::TOOLBAR} COMMA
-    {"VERSIONINFO" COMMA Keywords::VERSIONINFO} COMMA
-    {"RT_RIBBON_XML" COMMA Keywords::RT_RIBBON_XML} COMMA
-    {"PRELOAD" COMMA Keywords::IGNORE_16BITS} COMMA
-    {"LOADONCALL" COMMA Keywords::IGNORE_16BITS} COMMA
-    {"FIXED" COMMA Keywords::IGNORE_16BITS} COMMA
-    {"MOVEABLE" COMMA Keywords::IGNORE_16BITS} COMMA
-    {"DISCARDABLE" COMMA Keywords::IGNORE_16BITS} COMMA
-    {"PURE" COMMA Keywords::IGNORE_16BITS} COMMA
-    {"IMPURE" COMMA Keywords::IGNORE_16BITS} COMMA
-    {"SHARED" COMMA Keywords::IGNORE_16BITS} COMMA
-    {"NONSHARED" COMMA Keywords::IGNORE_16BITS} COMMA
-    {"BEGIN" COMMA Keywords::BEGIN} COMMA
-    {"END" COMMA Keywords::END} COMMA
-    {"SEPARATOR" COMMA Keywords::SEPARATOR} COMMA
-    {"MFT_SEPARATOR" COMMA Keywords::SEPARATOR} COMMA
-    {"BUTTON" COMMA Keywords::BUTTON} COMMA
-    {"NOT" COMMA Keywords::NOT} COMMA
-    {"CHECKED" COMMA Keywords::CHECKED} COMMA
-    {"MFS_CHECKED" COMMA Keywords::CHECKED} COMMA
-    {"GRAYED" COMMA Keywords::GRAYED} COMMA
-    {"MFS_GRAYED" COMMA Keywords::GRAYED} COMMA
-    {"MFS_DISABLED" COMMA Keywords::INACTIVE} COMMA
-    {"HELP" COMMA Keywords::HELP} COMMA
-    {"INACTIVE" COMMA Keywords::INACTIVE} COMMA
-    {"MENUBARBREAK" COMMA Keywords::MENUBARBREAK} COMMA
-    {"MFT_MENUBARBREAK" COMMA Keywords::MENUBARBREAK} COMMA
-    {"MENUBREAK" COMMA Keywords::MENUBREAK} COMMA
-    {"MFT_MENUBREAK" COMMA Keywords::MENUBREAK} COMMA
-    {"MFT_STRING" COMMA Keywords::MFTSTRING} COMMA
-    {"MFS_ENABLED" COMMA Keywords::MFSENABLED} COMMA
-    {"MFT_RIGHTJUSTIFY" COMMA Keywords::MFTRIGHTJUSTIFY} COMMA
-    {"ALT" COMMA Keywords::ALT} COMMA
-    {"ASCII" COMMA Keywords::ASCII} COMMA
-    {"NOINVERT" COMMA Keywords::NOINVERT} COMMA
-    {"SHIFT" COMMA Keywords::SHIFT} COMMA
-    {"VIRTKEY" COMMA Keywords::VIRTKEY} COMMA
-    {"CAPTION" COMMA Keywords::CAPTION} COMMA
-    {"CHARACTERISTICS" COMMA Keywords::CHARACTERISTICS} COMMA
-    {"CLASS" COMMA Keywords::CLASS} COMMA
-    {"EXSTYLE" COMMA Keywords::EXSTYLE} COMMA
-    {"LANGUAGE" COMMA Keywords::LANGUAGE} COMMA
-    {"MENUITEM" COMMA Keywords::MENUITEM} COMMA
-    {"STYLE" COMMA Keywords::STYLE} COMMA
-    {"VERSION" COMMA Keywords::VERSION} COMMA
-    {"AUTO3STATE" COMMA Keywords::AUTO3STATE} COMMA
-    {"AUTOCHECKBOX" COMMA Keywords::AUTOCHECKBOX} COMMA
-    {"AUTORADIOBUTTON" COMMA Keywords::AUTORADIOBUTTON} COMMA
-    {"CHECKBOX" COMMA Keywords::CHECKBOX} COMMA
-    {"COMBOBOX" COMMA Keywords::COMBOBOX} COMMA
-    {"CONTROL" COMMA Keywords::CONTROL} COMMA
-    {"CTEXT" COMMA Keywords::CTEXT} COMMA
-    {"DEFPUSHBUTTON" COMMA Keywords::DEFPUSHBUTTON} COMMA
-    {"EDITTEXT" COMMA Keywords::EDITTEXT} COMMA
-    {"GROUPBOX" COMMA Keywords::GROUPBOX} COMMA
-    {"LISTBOX" COMMA Keywords::LISTBOX} COMMA
-    {"LTEXT" COMMA Keywords::LTEXT} COMMA
-    {"PUSHBOX" COMMA Keywords::PUSHBOX} COMMA
-    {"PUSHBUTTON" COMMA Keywords::PUSHBUTTON} COMMA
-    {"RADIOBUTTON" COMMA Keywords::RADIOBUTTON} COMMA
-    {"RTEXT" COMMA Keywords::RTEXT} COMMA
-    {"SCROLLBAR" COMMA Keywords::SCROLLBAR} COMMA
-    {"STATE3" COMMA Keywords::STATE3} COMMA
-});
+    KeywordEntry{"ACCELERATORS", Keywords::ACCELERATORS},
+    KeywordEntry{"AFX_DIALOG_LAYOUT", Keywords::AFX_DIALOG_LAYOUT},
+    KeywordEntry{"BITMAP", Keywords::BITMAP},
+    KeywordEntry{"CURSOR", Keywords::CURSOR},
+    KeywordEntry{"DESIGNINFO", Keywords::DESIGNINFO},
+    KeywordEntry{"DIALOG", Keywords::DIALOG},
+    KeywordEntry{"DIALOGEX", Keywords::DIALOGEX},
+    KeywordEntry{"DLGINIT", Keywords::DLGINIT},
+    KeywordEntry{"FONT", Keywords::FONT},
+    KeywordEntry{"HTML", Keywords::HTML},
+    KeywordEntry{"ICON", Keywords::ICON},
+    KeywordEntry{"IMAGE", Keywords::IMAGE},
+    KeywordEntry{"MENU", Keywords::MENU},
+    KeywordEntry{"MENUEX", Keywords::MENUEX},
+    KeywordEntry{"MESSAGETABLE", Keywords::MESSAGETABLE},
+    KeywordEntry{"PNG", Keywords::PNG},
+    KeywordEntry{"POPUP", Keywords::POPUP},
+    KeywordEntry{"RCDATA", Keywords::RCDATA},
+    KeywordEntry{"REGISTRY", Keywords::REGISTRY},
+    KeywordEntry{"STRINGTABLE", Keywords::STRINGTABLE},
+    KeywordEntry{"TEXTINCLUDE", Keywords::TEXTINCLUDE},
+    KeywordEntry{"TOOLBAR", Keywords::TOOLBAR},
+    KeywordEntry{"VERSIONINFO", Keywords::VERSIONINFO},
+    KeywordEntry{"RT_RIBBON_XML", Keywords::RT_RIBBON_XML},
+    KeywordEntry{"PRELOAD", Keywords::IGNORE_16BITS},
+    KeywordEntry{"LOADONCALL", Keywords::IGNORE_16BITS},
+    KeywordEntry{"FIXED", Keywords::IGNORE_16BITS},
+    KeywordEntry{"MOVEABLE", Keywords::IGNORE_16BITS},
+    KeywordEntry{"DISCARDABLE", Keywords::IGNORE_16BITS},
+    KeywordEntry{"PURE", Keywords::IGNORE_16BITS},
+    KeywordEntry{"IMPURE", Keywords::IGNORE_16BITS},
+    KeywordEntry{"SHARED", Keywords::IGNORE_16BITS},
+    KeywordEntry{"NONSHARED", Keywords::IGNORE_16BITS},
+    KeywordEntry{"BEGIN", Keywords::BEGIN},
+    KeywordEntry{"END", Keywords::END},
+    KeywordEntry{"SEPARATOR", Keywords::SEPARATOR},
+    KeywordEntry{"MFT_SEPARATOR", Keywords::SEPARATOR},
+    KeywordEntry{"BUTTON", Keywords::BUTTON},
+    KeywordEntry{"NOT", Keywords::NOT},
+    KeywordEntry{"CHECKED", Keywords::CHECKED},
+    KeywordEntry{"MFS_CHECKED", Keywords::CHECKED},
+    KeywordEntry{"GRAYED", Keywords::GRAYED},
+    KeywordEntry{"MFS_GRAYED", Keywords::GRAYED},
+    KeywordEntry{"MFS_DISABLED", Keywords::INACTIVE},
+    KeywordEntry{"HELP", Keywords::HELP},
+    KeywordEntry{"INACTIVE", Keywords::INACTIVE},
+    KeywordEntry{"MENUBARBREAK", Keywords::MENUBARBREAK},
+    KeywordEntry{"MFT_MENUBARBREAK", Keywords::MENUBARBREAK},
+    KeywordEntry{"MENUBREAK", Keywords::MENUBREAK},
+    KeywordEntry{"MFT_MENUBREAK", Keywords::MENUBREAK},
+    KeywordEntry{"MFT_STRING", Keywords::MFTSTRING},
+    KeywordEntry{"MFS_ENABLED", Keywords::MFSENABLED},
+    KeywordEntry{"MFT_RIGHTJUSTIFY", Keywords::MFTRIGHTJUSTIFY},
+    KeywordEntry{"ALT", Keywords::ALT},
+    KeywordEntry{"ASCII", Keywords::ASCII},
+    KeywordEntry{"NOINVERT", Keywords::NOINVERT},
+    KeywordEntry{"SHIFT", Keywords::SHIFT},
+    KeywordEntry{"VIRTKEY", Keywords::VIRTKEY},
+    KeywordEntry{"CAPTION", Keywords::CAPTION},
+    KeywordEntry{"CHARACTERISTICS", Keywords::CHARACTERISTICS},
+    KeywordEntry{"CLASS", Keywords::CLASS},
+    KeywordEntry{"EXSTYLE", Keywords::EXSTYLE},
+    KeywordEntry{"LANGUAGE", Keywords::LANGUAGE},
+    KeywordEntry{"MENUITEM", Keywords::MENUITEM},
+    KeywordEntry{"STYLE", Keywords::STYLE},
+    KeywordEntry{"VERSION", Keywords::VERSION},
+    KeywordEntry{"AUTO3STATE", Keywords::AUTO3STATE},
+    KeywordEntry{"AUTOCHECKBOX", Keywords::AUTOCHECKBOX},
+    KeywordEntry{"AUTORADIOBUTTON", Keywords::AUTORADIOBUTTON},
+    KeywordEntry{"CHECKBOX", Keywords::CHECKBOX},
+    KeywordEntry{"COMBOBOX", Keywords::COMBOBOX},
+    KeywordEntry{"CONTROL", Keywords::CONTROL},
+    KeywordEntry{"CTEXT", Keywords::CTEXT},
+    KeywordEntry{"DEFPUSHBUTTON", Keywords::DEFPUSHBUTTON},
+    KeywordEntry{"EDITTEXT", Keywords::EDITTEXT},
+    KeywordEntry{"GROUPBOX", Keywords::GROUPBOX},
+    KeywordEntry{"LISTBOX", Keywords::LISTBOX},
+    KeywordEntry{"LTEXT", Keywords::LTEXT},
+    KeywordEntry{"PUSHBOX", Keywords::PUSHBOX},
+    KeywordEntry{"PUSHBUTTON", Keywords::PUSHBUTTON},
+    KeywordEntry{"RADIOBUTTON", Keywords::RADIOBUTTON},
+    KeywordEntry{"RTEXT", Keywords::RTEXT},
+    KeywordEntry{"SCROLLBAR", Keywords::SCROLLBAR},
+    KeywordEntry{"STATE3", Keywords::STATE3},
+};
 // clang-format on
 
+// Keywords are recognized using a perfect hash: the seed is computed at compile time so that no two keywords end up
+// in the same slot. A lookup is then one hash computation and one string comparison.
+constexpr std::size_t KeywordSlotCount = 1024;
+constexpr std::uint8_t NoKeyword = 0xff;
+static_assert(KeywordTable.size() < NoKeyword);
+
+template <typename Char>
+constexpr std::size_t keywordSlot(const Char *text, qsizetype size, std::uint32_t seed)
+{
+    // FNV-1a
+    std::uint32_t hash = 2166136261u ^ seed;
+    for (qsizetype i = 0; i < size; ++i) {
+        hash ^= static_cast<std::uint32_t>(text[i]);
+        hash *= 16777619u;
+    }
+    return (hash ^ (hash >> 16)) % KeywordSlotCount;
+}
+
+constexpr std::uint32_t computeKeywordSeed()
+{
+    for (std::uint32_t seed = 1; seed < 100000; ++seed) {
+        std::array<bool, KeywordSlotCount> used = {};
+        bool collision = false;
+        for (const auto &entry : KeywordTable) {
+            const auto slot = keywordSlot(entry.name.data(), entry.name.size(), seed);
+            if (used[slot]) {
+                collision = true;
+                break;
+            }
+            used[slot] = true;
+        }
+        if (!collision)
+            return seed;
+    }
+    return 0;
+}
+
+constexpr std::uint32_t KeywordSeed = computeKeywordSeed();
+static_assert(KeywordSeed != 0, "No perfect hash found for the RC keywords");
+
+constexpr auto KeywordSlots = [] {
+    std::array<std::uint8_t, KeywordSlotCount> slots = {};
+    for (auto &slot : slots)
+        slot = NoKeyword;
+    for (std::size_t i = 0; i < KeywordTable.size(); ++i) {
+        const auto &name = KeywordTable[i].name;
+        slots[keywordSlot(name.data(), name.size(), KeywordSeed)] = static_cast<std::uint8_t>(i);
+    }
+    return slots;
+}();
+
+static std::optional<Keywords> findKeyword(QStringView word)
+{
+    const auto index = KeywordSlots[keywordSlot(word.utf16(), word.size(), KeywordSeed)];
+    if (index == NoKeyword)
+        return {};
+    const auto &entry = KeywordTable[index];
+    if (word != QLatin1StringView(entry.name.data(), entry.name.size()))
+        return {};
+    return entry.keyword;
+}
+
+static QString keywordName(Keywords keyword)
+{
+    for (const auto &entry : KeywordTable) {
+        if (entry.keyword == keyword)
+            return QLatin1StringView(entry.name.data(), entry.name.size()).toString();
+    }
+    return {};
+}
+
 //=============================================================================
 // Parser::Token
 //=============================================================================
 
 QString Token::toString() const
 {
-    if (data.index() == 1)
-        return std::get<QString>(data);
-    return KeywordMap->key(std::get<Keywords>(data));
+    if (const auto text = std::get_if<QString>(&data))
+        return *text;
+    if (const auto text = std::get_if<QStringView>(&data))
+        return text->toString();
+    return keywordName(std::get<Keywords>(data));
 }
 
 QString Token::prettyPrint() const
@@ -132,7 +216,7 @@ QString Token::prettyPrint() const
     case Token::Integer:
         return QString::number(toInt());
     case Token::Keyword:
-        return KeywordMap->key(toKeyword());
+        return keywordName(toKeyword());
     case Token::Word:
         return toString();
     }
@@ -179,12 +263,12 @@ void Lexer::skipScope()
         skipSpace();
         const QChar &ch = m_stream.peek();
         if (ch == 'B' || ch == 'E') {
-            const QString word = readWhile([](const auto &c) {
+            const QStringView word = readWhile([](const auto &c) {
                 return c.isLetter();
             });
-            if (word == "BEGIN")
+            if (word == "BEGIN"_L1)
                 ++scope;
-            else if (word == "END")
+            else if (word == "END"_L1)
                 --scope;
         }
         skipLine();
@@ -202,10 +286,10 @@ void Lexer::skipToBegin()
         skipSpace();
         const QChar &ch = m_stream.peek();
         if (ch == 'B') {
-            const QString word = readWhile([](const auto &c) {
+            const QStringView word = readWhile([](const auto &c) {
                 return c.isLetter();
             });
-            if (word == "BEGIN")
+            if (word == "BEGIN"_L1)
                 return;
         }
         skipLine();
@@ -231,7 +315,11 @@ std::optional<Token> Lexer::peek()
 
 QList<QString> Lexer::keywords()
 {
-    return KeywordMap->keys();
+    QList<QString> result;
+    result.reserve(KeywordTable.size());
+    for (const auto &entry : KeywordTable)
+        result.push_back(QLatin1StringView(entry.name.data(), entry.name.size()).toString());
+    return result;
 }
 
 std::optional<Token> Lexer::readNext()
@@ -245,6 +333,9 @@ std::optional<Token> Lexer::readNext()
         skipLine();
         return readNext();
     }
+
+    m_tokenPosition = m_stream.position();
+    m_tokenLine = m_stream.line();
     if (ch == '"')
         return readString();
     if (ch == ',') {
@@ -280,9 +371,32 @@ Token Lexer::readDirective()
 
 Token Lexer::readString()
 {
-    QString str;
     m_stream.next(); // Read the first '"'
+    const int start = m_stream.position();
+
+    // Fast path: as long as there are no escaped characters, the token is a view on the content
+    QString str;
     bool escaped = false;
+    while (true) {
+        if (m_stream.atEnd())
+            return {Token::String, m_stream.slice(start)};
+        const QChar &ch = m_stream.peek();
+        if (ch == '\\') {
+            str = m_stream.slice(start).toString();
+            break;
+        }
+        m_stream.next();
+        if (ch == '"') {
+            // " are escaped with "" in RC files
+            if (m_stream.peek() != '"')
+                return {Token::String, m_stream.slice(start).chopped(1)};
+            str = m_stream.slice(start).chopped(1).toString();
+            escaped = true;
+            break;
+        }
+    }
+
+    // Slow path: unescape the rest of the string
     while (!m_stream.atEnd()) {
         const QChar &ch = m_stream.next();
         if (escaped) {
@@ -312,42 +426,39 @@ Token Lexer::readString()
 
 Token Lexer::readInclude()
 {
-    QString str;
-    m_stream.next(); // Read the first '"'
-    while (!m_stream.atEnd()) {
-        const QChar &ch = m_stream.next();
-        if (ch == '>')
-            break;
-        else
-            str += ch;
-    }
+    m_stream.next(); // Read the first '<'
+    const QStringView str = readWhile([](const auto &c) {
+        return c != '>';
+    });
+    m_stream.next(); // Read the last '>'
     return {Token::String, str};
 }
 
 Token Lexer::readNumber()
 {
-    QString text = m_stream.next();
-    if (text[0] == '0' && m_stream.peek() == 'x') {
-        text += m_stream.next();
-        text += readWhile([](const auto &c) {
+    const int start = m_stream.position();
+    const QChar first = m_stream.next();
+    if (first == '0' && m_stream.peek() == 'x') {
+        m_stream.next();
+        skipWhile([](const auto &c) {
             return c.isLetterOrNumber();
         });
-        return {Token::Word, text};
+        return {Token::Word, m_stream.slice(start)};
     }
 
-    text += readWhile([](const auto &c) {
+    skipWhile([](const auto &c) {
         return c.isNumber();
     });
-    return {Token::Integer, text.toInt()};
+    return {Token::Integer, m_stream.slice(start).toInt()};
 }
 
 Token Lexer::readWord()
 {
-    const QString word = readWhile([](const auto &c) {
+    const QStringView word = readWhile([](const auto &c) {
         return c.isLetterOrNumber() || c == '_';
     });
-    if (auto it = KeywordMap->find(word); it != KeywordMap->end())
-        return {Token::Keyword, it.value()};
+    if (const auto keyword = findKeyword(word))
+        return {Token::Keyword, *keyword};
     return {Token::Word, word};
 }
 
@@ -13,6 +13,7 @@
 #include "stream.h"
 
 #include <QString>
+#include <QStringView>
 #include <QVariant>
 #include <optional>
 #include <variant>
@@ -125,7 +126,9 @@ struct Token
         Word, // All the rest
     };
     Type type = Word;
-    std::variant<std::monostate, QString, int, Keywords> data;
+    // Words, directives and most strings are views on the lexer content: they are only valid as long as the lexer
+    // is alive. Strings with escaped characters are stored as QString.
+    std::variant<std::monostate, QString, int, Keywords, QStringView> data;
 
     QString toString() const;
     int toInt() const { return std::get<int>(data); }
@@ -146,7 +149,7 @@ public:
     void skipToBegin();
 
     int line() const { return m_stream.line(); }
-    QString content() const { return m_stream.content(); }
+    const QString &content() const { return m_stream.content(); }
 
     void setFileName(const QString &name) { m_fileName = name; }
     QString fileName() const { return m_fileName; }
@@ -154,6 +157,10 @@ public:
     std::optional<Token> next();
     std::optional<Token> peek();
 
+    // Position and line of the start of the last token read, either with next or peek
+    int tokenPosition() const { return m_tokenPosition; }
+    int tokenLine() const { return m_tokenLine; }
+
     static QList<QString> keywords();
 
 private:
@@ -166,12 +173,11 @@ private:
             m_stream.next();
     }
     template <typename Func>
-    QString readWhile(Func func)
+    QStringView readWhile(Func func)
     {
-        QString result;
-        while (!m_stream.atEnd() && std::invoke(func, m_stream.peek()))
-            result += m_stream.next();
-        return result;
+        const int start = m_stream.position();
+        skipWhile(func);
+        return m_stream.slice(start);
     }
 
     Token readDirective();
@@ -184,6 +190,8 @@ private:
     Stream m_stream;
     std::optional<Token> m_current;
     QString m_fileName;
+    int m_tokenPosition = 0;
+    int m_tokenLine = 1;
 };
 
 } // namespace RcCore
@@ -14,7 +14,7 @@
 
 #include <QDir>
 #include <QHash>
-#include <QImage>
+#include <QImageReader>
 #include <algorithm>
 #include <cmath>
 #include <pugixml.hpp>
@@ -30,10 +30,11 @@ static QList<Asset> splitToolBar(const Data &data, const ToolBar &toolBar, const
     });
     const int zeroCount = static_cast<int>(std::log10(iconCount)) + 1;
 
-    QImage image(asset.originalFileName);
+    // Only read the image header, the image is decoded when writing the assets
+    const QSize imageSize = QImageReader(asset.originalFileName).size();
     const int width = toolBar.iconSize.width();
 
-    if (iconCount * width != image.width()) {
+    if (iconCount * width != imageSize.width()) {
         spdlog::warn("{}({}): asset and toolbar widths don't match for {}", data.fileName, asset.line, asset.id);
     }
 
@@ -97,67 +98,65 @@ QList<Asset> convertAssets(const Data &data, Asset::ConversionFlags flags)
 //=============================================================================
 // Dialog conversion
 //=============================================================================
-static void convertFrame(Widget &widget, Data::Control &control)
+static void convertFrame(Widget &widget, const Data::Control &control, QStringList &styles)
 {
-    if (control.styles.removeOne("WS_EX_CLIENTEDGE")) {
+    if (styles.removeOne("WS_EX_CLIENTEDGE")) {
         widget.properties["frameShape"] = "QFrame::Panel";
         widget.properties["frameShadow"] = "QFrame::Sunken";
         widget.properties["lineWidth"] = 2;
     }
-    if (control.styles.removeOne("WS_EX_STATICEDGE")) {
+    if (styles.removeOne("WS_EX_STATICEDGE")) {
         widget.properties["frameShape"] = "QFrame::Panel";
         widget.properties["frameShadow"] = "QFrame::Sunken";
     }
-    if (control.styles.removeOne("WS_EX_DLGMODALFRAME")) {
+    if (styles.removeOne("WS_EX_DLGMODALFRAME")) {
         widget.properties["frameShape"] = "QFrame::Panel";
         widget.properties["frameShadow"] = "QFrame::Raiseds";
     }
-    if (control.styles.removeOne("WS_BORDER")) {
+    if (styles.removeOne("WS_BORDER")) {
         widget.properties["frameShape"] = "QFrame::Box";
     }
-    if (control.styles.removeOne("SS_BLACKFRAME")) {
+    if (styles.removeOne("SS_BLACKFRAME")) {
         widget.properties["frameShape"] = "QFrame::Box";
     }
-    if (control.styles.removeOne("SS_SUNKEN")) {
+    if (styles.removeOne("SS_SUNKEN")) {
         widget.properties["frameShape"] = "QFrame::Panel";
         widget.properties["frameShadow"] = "QFrame::Sunken";
     }
 }
 
-static void convertStyles(const Data &data, Widget &widget, Data::Control &control, bool isFrame = false)
+static void convertStyles(const Data &data, Widget &widget, const Data::Control &control, QStringList &styles,
+                          bool isFrame = false)
 {
     if (isFrame) {
-        convertFrame(widget, control);
+        convertFrame(widget, control, styles);
     }
 
-    if (control.styles.removeOne("WS_DISABLED")) {
+    if (styles.removeOne("WS_DISABLED")) {
         widget.properties["enabled"] = false;
     }
 
     // WS_TABSTOP is handled by Qt widgets (focus navigation)
-    control.styles.removeOne("WS_TABSTOP");
+    styles.removeOne("WS_TABSTOP");
 
-    if (!control.styles.isEmpty()) {
-        spdlog::info("{}({}): {} has unused styles {}", data.fileName, control.line, control.id,
-                     control.styles.join(", "));
+    if (!styles.isEmpty()) {
+        spdlog::info("{}({}): {} has unused styles {}", data.fileName, control.line, control.id, styles.join(", "));
     }
 }
 // https://docs.microsoft.com/en-us/windows/desktop/menurc/defpushbutton-control
 // https://docs.microsoft.com/en-us/windows/desktop/menurc/pushbox-control
 // https://docs.microsoft.com/en-us/windows/desktop/menurc/pushbutton-control
 // https://docs.microsoft.com/en-us/windows/desktop/controls/button-styles
-static Widget convertPushButton(const Data &data, const QString &dialogId, Data::Control &control)
+static Widget convertPushButton(const Data &data, const QString &dialogId, const Data::Control &control,
+                                QStringList &styles)
 {
     Widget widget;
     widget.className = "QPushButton";
     widget.properties["text"] = control.text;
 
     // Initialize the values if they exists
-    const auto it = std::ranges::find_if(data.dialogDataList, [dialogId](const auto &dialogData) {
-        return dialogData.id == dialogId;
-    });
-    if (it != data.dialogDataList.cend()) {
-        const auto &values = it->values.value(control.id);
+    if (const auto dialogData = data.dialogData(dialogId)) {
+        const auto &values = dialogData->values.value(control.id);
         if (values.count() == 1) {
             pugi::xml_document document;
             const pugi::xml_parse_result result = document.load_string(values.constFirst().toLatin1().constData(),
@@ -171,37 +170,37 @@ static Widget convertPushButton(const Data &data, const QString &dialogId, Data:
         }
     }
 
-    if (control.styles.removeOne("BS_AUTO3STATE") || control.styles.removeOne("BS_3STATE")
-        || control.styles.removeOne("BS_CHECKBOX") || control.styles.removeOne("BS_RADIOBUTTON")
-        || control.styles.removeOne("BS_AUTOCHECKBOX") || control.styles.removeOne("BS_AUTORADIOBUTTON"))
+    if (styles.removeOne("BS_AUTO3STATE") || styles.removeOne("BS_3STATE") || styles.removeOne("BS_CHECKBOX")
+        || styles.removeOne("BS_RADIOBUTTON") || styles.removeOne("BS_AUTOCHECKBOX")
+        || styles.removeOne("BS_AUTORADIOBUTTON"))
         widget.properties["checkable"] = true;
 
-    if (control.styles.removeOne("BS_DEFPUSHBUTTON") || control.type == static_cast<int>(Keywords::DEFPUSHBUTTON))
+    if (styles.removeOne("BS_DEFPUSHBUTTON") || control.type == static_cast<int>(Keywords::DEFPUSHBUTTON))
         widget.properties["default"] = true;
 
     // The button has an image, but it's handled with the message BM_SETIMAGE, in code
     // No need to port here
-    control.styles.removeOne("BS_BITMAP");
-    control.styles.removeOne("BS_ICON");
+    styles.removeOne("BS_BITMAP");
+    styles.removeOne("BS_ICON");
 
-    if (control.styles.removeOne("BS_FLAT") || control.type == static_cast<int>(Keywords::PUSHBOX))
+    if (styles.removeOne("BS_FLAT") || control.type == static_cast<int>(Keywords::PUSHBOX))
         widget.properties["flat"] = true;
 
-    convertStyles(data, widget, control);
+    convertStyles(data, widget, control, styles);
     return widget;
 }
 
 // https://docs.microsoft.com/en-us/windows/desktop/menurc/radiobutton-control
 // https://docs.microsoft.com/en-us/windows/desktop/menurc/autoradiobutton-control
-static Widget convertRadioButton(const Data &data, Data::Control &control)
+static Widget convertRadioButton(const Data &data, const Data::Control &control, QStringList &styles)
 {
     Widget widget;
     widget.className = "QRadioButton";
     widget.properties["text"] = control.text;
 
-    control.styles.removeOne("BS_RADIOBUTTON");
-    control.styles.removeOne("BS_AUTORADIOBUTTON");
-    convertStyles(data, widget, control);
+    styles.removeOne("BS_RADIOBUTTON");
+    styles.removeOne("BS_AUTORADIOBUTTON");
+    convertStyles(data, widget, control, styles);
     return widget;
 }
 
@@ -209,55 +208,54 @@ static Widget convertRadioButton(const Data &data, Data::Control &control)
 // https://docs.microsoft.com/en-us/windows/desktop/menurc/autocheckbox-control
 // https://docs.microsoft.com/en-us/windows/desktop/menurc/checkbox-control
 // https://docs.microsoft.com/en-us/windows/desktop/menurc/state3-control
-static Widget convertCheckBox(const Data &data, Data::Control &control)
+static Widget convertCheckBox(const Data &data, const Data::Control &control, QStringList &styles)
 {
     Widget widget;
     widget.className = "QCheckBox";
     widget.properties["text"] = control.text;
 
-    if (control.styles.removeOne("BS_AUTO3STATE") || control.styles.removeOne("BS_3STATE")
+    if (styles.removeOne("BS_AUTO3STATE") || styles.removeOne("BS_3STATE")
         || control.type == static_cast<int>(Keywords::STATE3) || control.type == static_cast<int>(Keywords::AUTO3STATE))
         widget.properties["tristate"] = true;
 
-    control.styles.removeOne("BS_CHECKBOX");
-    control.styles.removeOne("BS_AUTOCHECKBOX");
+    styles.removeOne("BS_CHECKBOX");
+    styles.removeOne("BS_AUTOCHECKBOX");
 
-    convertStyles(data, widget, control);
+    convertStyles(data, widget, control, styles);
     return widget;
 }
 
 // https://learn.microsoft.com/en-us/windows/desktop/menurc/combobox-control
-static Widget convertComboBox(const Data &data, const QString &dialogId, Data::Control &control)
+static Widget convertComboBox(const Data &data, const QString &dialogId, const Data::Control &control,
+                              QStringList &styles)
 {
     Widget widget;
     widget.className = "QComboBox";
 
-    if (control.styles.removeOne("CBS_SIMPLE")) {
+    if (styles.removeOne("CBS_SIMPLE")) {
         widget.className = "QListWidget";
     } else {
         // In MFC, the height is not the height of the combobox
         // So we take the "default" height of a combobox
-        control.geometry.setHeight(22);
+        widget.geometry = control.geometry;
+        widget.geometry.setHeight(22);
 
-        if (control.styles.removeOne("CBS_DROPDOWN")) {
+        if (styles.removeOne("CBS_DROPDOWN")) {
             widget.properties["editable"] = true;
             widget.properties["insertPolicy"] = "QComboBox::NoInsert";
         }
     }
 
     // Initialize the values if they exists
-    const auto it = std::ranges::find_if(data.dialogDataList, [dialogId](const auto &dialogData) {
-        return dialogData.id == dialogId;
-    });
-    if (it != data.dialogDataList.cend()) {
-        const auto &values = it->values.value(control.id);
+    if (const auto dialogData = data.dialogData(dialogId)) {
+        const auto &values = dialogData->values.value(control.id);
         if (!values.isEmpty())
             widget.properties["text"] = values;
     }
 
-    control.styles.removeOne("CBS_DROPDOWNLIST");
-    control.styles.removeOne("WS_VSCROLL");
-    convertStyles(data, widget, control);
+    styles.removeOne("CBS_DROPDOWNLIST");
+    styles.removeOne("WS_VSCROLL");
+    convertStyles(data, widget, control, styles);
     return widget;
 }
 
@@ -265,21 +263,21 @@ static Widget convertComboBox(const Data &data, const QString &dialogId, Data::C
 // https://docs.microsoft.com/en-us/windows/desktop/menurc/r"text"-control
 // https://docs.microsoft.com/en-us/windows/desktop/menurc/c"text"-control
 // https://docs.microsoft.com/en-us/windows/desktop/menurc/icon-control
-static Widget convertLabel(const Data &data, Data::Control &control, bool useIdForPixmap)
+static Widget convertLabel(const Data &data, const Data::Control &control, QStringList &styles, bool useIdForPixmap)
 {
     Widget widget;
     widget.className = "QLabel";
 
-    if (control.styles.removeOne("SS_RIGHT") || control.type == static_cast<int>(Keywords::RTEXT))
+    if (styles.removeOne("SS_RIGHT") || control.type == static_cast<int>(Keywords::RTEXT))
         widget.properties["alignment"] = "Qt::AlignRight";
-    if (control.styles.removeOne("SS_CENTER") || control.styles.removeOne("SS_CENTERIMAGE")
+    if (styles.removeOne("SS_CENTER") || styles.removeOne("SS_CENTERIMAGE")
         || control.type == static_cast<int>(Keywords::CTEXT))
         widget.properties["alignment"] = "Qt::AlignHCenter";
 
-    if (control.styles.removeOne("SS_REALSIZECONTROL"))
+    if (styles.removeOne("SS_REALSIZECONTROL"))
         widget.properties["scaledContents"] = true;
 
-    if (control.styles.removeOne("SS_BITMAP") || control.styles.removeOne("SS_ICON")
+    if (styles.removeOne("SS_BITMAP") || styles.removeOne("SS_ICON")
         || control.type == static_cast<int>(Keywords::ICON)) {
         if (useIdForPixmap) {
             widget.properties["pixmap"] = QStringLiteral(":/%1").arg(control.text);
@@ -294,62 +292,62 @@ static Widget convertLabel(const Data &data, Data::Control &control, bool useIdF
         widget.properties["text"] = control.text;
     }
 
-    if (control.styles.removeOne("SS_LEFTNOWORDWRAP"))
+    if (styles.removeOne("SS_LEFTNOWORDWRAP"))
         widget.properties["wordWrap"] = false;
 
-    control.styles.removeOne("SS_LEFT");
-    convertStyles(data, widget, control, true);
+    styles.removeOne("SS_LEFT");
+    convertStyles(data, widget, control, styles, true);
     return widget;
 }
 
 // https://docs.microsoft.com/en-us/windows/desktop/menurc/edit"text"-control
-static Widget convertEditText(const Data &data, Data::Control &control)
+static Widget convertEditText(const Data &data, const Data::Control &control, QStringList &styles)
 {
     Widget widget;
     bool hasFrame = false;
 
     // TODO what about RichEdit20W
-    if (control.styles.removeOne("ES_MULTILINE") || control.className == "RICHEDIT") {
+    if (styles.removeOne("ES_MULTILINE") || control.className == "RICHEDIT") {
         widget.className = "QTextEdit";
         hasFrame = true;
     } else {
         widget.className = "QLineEdit";
-        if (control.styles.removeOne("ES_CENTER"))
+        if (styles.removeOne("ES_CENTER"))
             widget.properties["alignment"] = "Qt::AlignCenter|Qt::AlignVCenter";
-        else if (control.styles.removeOne("ES_RIGHT"))
+        else if (styles.removeOne("ES_RIGHT"))
             widget.properties["alignment"] = "Qt::AlignRight|Qt::AlignVCenter";
-        else if (control.styles.removeOne("ES_LEFT")
+        else if (styles.removeOne("ES_LEFT")
                  || true) // this is the "default", but I want to remove the style too
             widget.properties["alignment"] = "Qt::AlignLeft|Qt::AlignVCenter";
 
-        if (control.styles.removeOne("ES_PASSWORD"))
+        if (styles.removeOne("ES_PASSWORD"))
             widget.properties["echoMode"] = "QLineEdit::Password";
     }
 
-    if (control.styles.removeOne("ES_READONLY"))
+    if (styles.removeOne("ES_READONLY"))
         widget.properties["readOnly"] = true;
 
-    convertStyles(data, widget, control, hasFrame);
+    convertStyles(data, widget, control, styles, hasFrame);
     return widget;
 }
 
 // https://docs.microsoft.com/en-us/windows/desktop/menurc/groupbox-control
-static Widget convertGroupBox(const Data &data, Data::Control &control)
+static Widget convertGroupBox(const Data &data, const Data::Control &control, QStringList &styles)
 {
     Widget widget;
     widget.className = "QGroupBox";
     widget.properties["title"] = control.text;
-    convertStyles(data, widget, control);
+    convertStyles(data, widget, control, styles);
     return widget;
 }
 
 // https://docs.microsoft.com/en-us/windows/desktop/menurc/listbox-control
-static Widget convertListWidget(const Data &data, Data::Control &control)
+static Widget convertListWidget(const Data &data, const Data::Control &control, QStringList &styles)
 {
     Widget widget;
     widget.className = "QListView";
     bool isListView = true;
-    if (control.styles.removeOne("LVS_REPORT")) {
+    if (styles.removeOne("LVS_REPORT")) {
         widget.className = "QTreeView";
         isListView = false;
     }
@@ -358,244 +356,246 @@ static Widget convertListWidget(const Data &data, Data::Control &control)
     if (isListView && control.type == static_cast<int>(Keywords::CONTROL) && control.className == "SysListView32")
         widget.properties["viewMode"] = "QListView::IconMode";
 
-    if (control.styles.removeOne("LBS_NOSEL"))
+    if (styles.removeOne("LBS_NOSEL"))
         widget.properties["selectionMode"] = "QAbstractItemView::NoSelection";
-    else if (control.styles.removeOne("LBS_MULTIPLESEL"))
+    else if (styles.removeOne("LBS_MULTIPLESEL"))
         widget.properties["selectionMode"] = "QAbstractItemView::MultiSelection";
-    else if (control.styles.removeOne("LBS_EXTENDEDSEL"))
+    else if (styles.removeOne("LBS_EXTENDEDSEL"))
         widget.properties["selectionMode"] = "QAbstractItemView::ExtendedSelection";
     else
         widget.properties["selectionMode"] = "QAbstractItemView::SingleSelection";
 
-    if (control.styles.removeOne("LBS_SORT") || control.styles.removeOne("LBS_STANDARD"))
+    if (styles.removeOne("LBS_SORT") || styles.removeOne("LBS_STANDARD"))
         widget.properties["SortingEnabled"] = true;
-    else if (control.styles.removeOne("LBS_MULTIPLESEL"))
+    else if (styles.removeOne("LBS_MULTIPLESEL"))
         widget.properties["selectionMode"] = "QAbstractItemView::MultiSelection";
 
-    bool alwaysOn = control.styles.removeOne("LBS_DISABLENOSCROLL");
-    if (control.styles.removeOne("WS_HSCROLL"))
+    bool alwaysOn = styles.removeOne("LBS_DISABLENOSCROLL");
+    if (styles.removeOne("WS_HSCROLL"))
         widget.properties["horizontalScrollBarPolicy"] = alwaysOn ? "Qt::ScrollBarAlwaysOn" : "Qt::ScrollBarAsNeeded";
     else
         widget.properties["horizontalScrollBarPolicy"] = "Qt::ScrollBarAlwaysOff";
-    if (control.styles.removeOne("WS_VSCROLL"))
+    if (styles.removeOne("WS_VSCROLL"))
         widget.properties["verticalScrollBarPolicy"] = alwaysOn ? "Qt::ScrollBarAlwaysOn" : "Qt::ScrollBarAsNeeded";
     else
         widget.properties["verticalScrollBarPolicy"] = "Qt::ScrollBarAlwaysOff";
 
-    convertStyles(data, widget, control, true);
+    convertStyles(data, widget, control, styles, true);
     return widget;
 }
 
 // https://docs.microsoft.com/en-us/windows/desktop/menurc/scrollbar-control
-static Widget convertScrollBar(const Data &data, Data::Control &control)
+static Widget convertScrollBar(const Data &data, const Data::Control &control, QStringList &styles)
 {
     Widget widget;
     widget.className = "QScrollBar";
 
-    if (control.styles.removeOne("SBS_VERT"))
+    if (styles.removeOne("SBS_VERT"))
         widget.properties["orientation"] = "Qt::Vertical";
-    else if (control.styles.removeOne("SBS_HORZ") || true) // We want to remove the style if it exits
+    else if (styles.removeOne("SBS_HORZ") || true) // We want to remove the style if it exits
         widget.properties["orientation"] = "Qt::Horizontal";
 
-    convertStyles(data, widget, control);
+    convertStyles(data, widget, control, styles);
     return widget;
 }
 
-static Widget convertButton(const Data &data, const QString &dialogId, Data::Control &control)
-{
-    if (control.styles.contains("BS_PUSHLIKE"))
-        return convertPushButton(data, dialogId, control);
-    if (control.styles.contains("BS_3STATE"))
-        return convertCheckBox(data, control);
-    if (control.styles.contains("BS_AUTO3STATE"))
-        return convertCheckBox(data, control);
-    if (control.styles.contains("BS_AUTOCHECKBOX"))
-        return convertCheckBox(data, control);
-    if (control.styles.contains("BS_AUTORADIOBUTTON"))
-        return convertRadioButton(data, control);
-    if (control.styles.contains("BS_CHECKBOX"))
-        return convertCheckBox(data, control);
-    if (control.styles.contains("BS_GROUPBOX"))
-        return convertGroupBox(data, control);
-    if (control.styles.contains("BS_DEFPUSHBUTTON"))
-        return convertPushButton(data, dialogId, control);
-    if (control.styles.contains("BS_PUSHBUTTON"))
-        return convertPushButton(data, dialogId, control);
-    if (control.styles.contains("BS_RADIOBUTTON"))
-        return convertRadioButton(data, control);
-    return convertPushButton(data, dialogId, control);
-}
-
-static Widget convertSlider(const Data &data, Data::Control &control)
+static Widget convertButton(const Data &data, const QString &dialogId, const Data::Control &control,
+                            QStringList &styles)
+{
+    if (styles.contains("BS_PUSHLIKE"))
+        return convertPushButton(data, dialogId, control, styles);
+    if (styles.contains("BS_3STATE"))
+        return convertCheckBox(data, control, styles);
+    if (styles.contains("BS_AUTO3STATE"))
+        return convertCheckBox(data, control, styles);
+    if (styles.contains("BS_AUTOCHECKBOX"))
+        return convertCheckBox(data, control, styles);
+    if (styles.contains("BS_AUTORADIOBUTTON"))
+        return convertRadioButton(data, control, styles);
+    if (styles.contains("BS_CHECKBOX"))
+        return convertCheckBox(data, control, styles);
+    if (styles.contains("BS_GROUPBOX"))
+        return convertGroupBox(data, control, styles);
+    if (styles.contains("BS_DEFPUSHBUTTON"))
+        return convertPushButton(data, dialogId, control, styles);
+    if (styles.contains("BS_PUSHBUTTON"))
+        return convertPushButton(data, dialogId, control, styles);
+    if (styles.contains("BS_RADIOBUTTON"))
+        return convertRadioButton(data, control, styles);
+    return convertPushButton(data, dialogId, control, styles);
+}
+
+static Widget convertSlider(const Data &data, const Data::Control &control, QStringList &styles)
 {
     Widget widget;
     widget.className = "QSlider";
 
-    if (control.styles.removeOne("TBS_VERT")) {
+    if (styles.removeOne("TBS_VERT")) {
         widget.properties["orientation"] = "Qt::Vertical";
         widget.properties["invertedAppearance"] = "true";
-    } else if (control.styles.removeOne("TBS_HORZ") || true) // We want to remove the style if it exits
+    } else if (styles.removeOne("TBS_HORZ") || true) // We want to remove the style if it exits
         widget.properties["orientation"] = "Qt::Horizontal";
 
-    if (control.styles.removeOne("TBS_NOTICKS"))
+    if (styles.removeOne("TBS_NOTICKS"))
         widget.properties["tickPosition"] = "QSlider::NoTicks";
-    if (control.styles.removeOne("TBS_BOTH"))
+    if (styles.removeOne("TBS_BOTH"))
         widget.properties["tickPosition"] = "QSlider::TicksBothSides";
-    if (control.styles.removeOne("TBS_LEFT"))
+    if (styles.removeOne("TBS_LEFT"))
         widget.properties["tickPosition"] = "QSlider::TicksLeft";
-    if (control.styles.removeOne("TBS_RIGHT"))
+    if (styles.removeOne("TBS_RIGHT"))
         widget.properties["tickPosition"] = "QSlider::TicksRight";
-    if (control.styles.removeOne("TBS_TOP"))
+    if (styles.removeOne("TBS_TOP"))
         widget.properties["tickPosition"] = "QSlider::TicksAbove";
-    if (control.styles.removeOne("TBS_BOTTOM"))
+    if (styles.removeOne("TBS_BOTTOM"))
         widget.properties["tickPosition"] = "QSlider::TicksBelow";
 
-    convertStyles(data, widget, control);
+    convertStyles(data, widget, control, styles);
     return widget;
 }
 
-static Widget convertSpinBox(const Data &data, Data::Control &control)
+static Widget convertSpinBox(const Data &data, const Data::Control &control, QStringList &styles)
 {
     Widget widget;
     widget.className = "QSpinBox";
-    convertStyles(data, widget, control, true);
+    convertStyles(data, widget, control, styles, true);
     return widget;
 }
 
-static Widget convertProgressBar(const Data &data, Data::Control &control)
+static Widget convertProgressBar(const Data &data, const Data::Control &control, QStringList &styles)
 {
     Widget widget;
     widget.className = "QProgressBar";
 
-    if (control.styles.removeOne("TBS_VERT"))
+    if (styles.removeOne("TBS_VERT"))
         widget.properties["orientation"] = "Qt::Vertical";
-    else if (control.styles.removeOne("TBS_HORZ") || true) // We want to remove the style if it exits
+    else if (styles.removeOne("TBS_HORZ") || true) // We want to remove the style if it exits
         widget.properties["orientation"] = "Qt::Horizontal";
 
-    convertStyles(data, widget, control);
+    convertStyles(data, widget, control, styles);
     return widget;
 }
 
-static Widget convertCalendarWidget(const Data &data, Data::Control &control)
+static Widget convertCalendarWidget(const Data &data, const Data::Control &control, QStringList &styles)
 {
     Widget widget;
     widget.className = "QCalendarWidget";
-    convertStyles(data, widget, control, true);
+    convertStyles(data, widget, control, styles, true);
     return widget;
 }
 
-static Widget convertDateTime(const Data &data, Data::Control &control)
+static Widget convertDateTime(const Data &data, const Data::Control &control, QStringList &styles)
 {
     Widget widget;
     widget.className = "QDateTimeEdit";
 
-    if (control.styles.removeOne("DTS_LONGDATEFORMAT"))
+    if (styles.removeOne("DTS_LONGDATEFORMAT"))
         widget.properties["displayFormat"] = "dddd, MMMM dd, yyyy";
-    if (control.styles.removeOne("DTS_SHORTDATEFORMAT"))
+    if (styles.removeOne("DTS_SHORTDATEFORMAT"))
         widget.properties["displayFormat"] = "M/d/yy";
-    if (control.styles.removeOne("DTS_SHORTDATECENTURYFORMAT"))
+    if (styles.removeOne("DTS_SHORTDATECENTURYFORMAT"))
         widget.properties["displayFormat"] = "M/d/yyyy";
-    if (control.styles.removeOne("DTS_TIMEFORMAT"))
+    if (styles.removeOne("DTS_TIMEFORMAT"))
         widget.properties["displayFormat"] = "hh:mm:ss";
 
     widget.properties["calendarPopup"] = true;
 
-    convertStyles(data, widget, control, true);
+    convertStyles(data, widget, control, styles, true);
     return widget;
 }
 
-static Widget convertIpAddress(const Data &data, Data::Control &control)
+static Widget convertIpAddress(const Data &data, const Data::Control &control, QStringList &styles)
 {
     Widget widget;
     widget.className = "QLineEdit";
 
     widget.properties["inputMask"] = "000.000.000.000;_";
 
-    convertStyles(data, widget, control, true);
+    convertStyles(data, widget, control, styles, true);
     return widget;
 }
 
-static Widget convertTreeWidget(const Data &data, Data::Control &control)
+static Widget convertTreeWidget(const Data &data, const Data::Control &control, QStringList &styles)
 {
     Widget widget;
     widget.className = "QTreeView";
-    convertStyles(data, widget, control, true);
+    convertStyles(data, widget, control, styles, true);
     return widget;
 }
 
-static Widget convertTabWidget(const Data &data, Data::Control &control)
+static Widget convertTabWidget(const Data &data, const Data::Control &control, QStringList &styles)
 {
     Widget widget;
     widget.className = "QTabWidget";
 
-    if (control.styles.removeOne("TCS_BOTTOM"))
+    if (styles.removeOne("TCS_BOTTOM"))
         widget.properties["tabPosition"] = "QTabWidget::South";
-    if (control.styles.removeOne("TCS_VERTICAL"))
+    if (styles.removeOne("TCS_VERTICAL"))
         widget.properties["tabPosition"] = "QTabWidget::West";
-    if (control.styles.removeOne("TCS_RIGHT"))
+    if (styles.removeOne("TCS_RIGHT"))
         widget.properties["tabPosition"] = "QTabWidget::East";
 
-    convertStyles(data, widget, control, true);
+    convertStyles(data, widget, control, styles, true);
     return widget;
 }
 
 // https://docs.microsoft.com/en-us/windows/desktop/menurc/control-control
-static Widget convertControl(const Data &data, const QString &dialogId, Data::Control &control, bool useIdForPixmap)
+static Widget convertControl(const Data &data, const QString &dialogId, const Data::Control &control,
+                             QStringList &styles, bool useIdForPixmap)
 {
     if (control.className == "Static")
-        return convertLabel(data, control, useIdForPixmap);
+        return convertLabel(data, control, styles, useIdForPixmap);
     if (control.className == "Button")
-        return convertButton(data, dialogId, control);
+        return convertButton(data, dialogId, control, styles);
     if (control.className == "ComboBox")
-        return convertComboBox(data, dialogId, control);
+        return convertComboBox(data, dialogId, control, styles);
     if (control.className == "ComboBoxEx32")
-        return convertComboBox(data, dialogId, control);
+        return convertComboBox(data, dialogId, control, styles);
     if (control.className == "Edit")
-        return convertEditText(data, control);
+        return convertEditText(data, control, styles);
     if (control.className == "RICHEDIT")
-        return convertEditText(data, control);
+        return convertEditText(data, control, styles);
     if (control.className == "RichEdit20W")
-        return convertEditText(data, control);
+        return convertEditText(data, control, styles);
     if (control.className == "RichEdit20A")
-        return convertEditText(data, control);
+        return convertEditText(data, control, styles);
     if (control.className == "msctls_trackbar")
-        return convertSlider(data, control);
+        return convertSlider(data, control, styles);
     if (control.className == "msctls_trackbar32")
-        return convertSlider(data, control);
+        return convertSlider(data, control, styles);
     if (control.className == "msctls_updown")
-        return convertSpinBox(data, control);
+        return convertSpinBox(data, control, styles);
     if (control.className == "msctls_updown32")
-        return convertSpinBox(data, control);
+        return convertSpinBox(data, control, styles);
     if (control.className == "msctls_progress")
-        return convertProgressBar(data, control);
+        return convertProgressBar(data, control, styles);
     if (control.className == "msctls_progress32")
-        return convertProgressBar(data, control);
+        return convertProgressBar(data, control, styles);
     if (control.className == "ScrollBar")
-        return convertScrollBar(data, control);
+        return convertScrollBar(data, control, styles);
     if (control.className == "SysMonthCal32")
-        return convertCalendarWidget(data, control);
+        return convertCalendarWidget(data, control, styles);
     if (control.className == "SysDateTimePick32")
-        return convertDateTime(data, control);
+        return convertDateTime(data, control, styles);
     if (control.className == "SysIPAddress32")
-        return convertIpAddress(data, control);
+        return convertIpAddress(data, control, styles);
     if (control.className == "SysListView")
-        return convertListWidget(data, control);
+        return convertListWidget(data, control, styles);
     if (control.className == "SysListView32")
-        return convertListWidget(data, control);
+        return convertListWidget(data, control, styles);
     if (control.className == "SysTreeView")
-        return convertTreeWidget(data, control);
+        return convertTreeWidget(data, control, styles);
     if (control.className == "SysTreeView32")
-        return convertTreeWidget(data, control);
+        return convertTreeWidget(data, control, styles);
     if (control.className == "SysTabControl")
-        return convertTabWidget(data, control);
+        return convertTabWidget(data, control, styles);
     if (control.className == "SysTabControl32")
-        return convertTabWidget(data, control);
+        return convertTabWidget(data, control, styles);
     if (control.className == "SysLink")
-        return convertLabel(data, control, useIdForPixmap);
+        return convertLabel(data, control, styles, useIdForPixmap);
     if (control.className == "MfcPropertyGrid")
-        return convertTreeWidget(data, control);
+        return convertTreeWidget(data, control, styles);
     if (control.className == "MfcButton")
-        return convertButton(data, dialogId, control);
+        return convertButton(data, dialogId, control, styles);
 
     spdlog::warn("{}({}): unknown CONTROL {} / {}", data.fileName, control.line, control.id, control.className);
 
@@ -604,8 +604,11 @@ static Widget convertControl(const Data &data, const QString &dialogId, Data::Co
     return widget;
 }
 
-static Widget convertChildWidget(const Data &data, const QString &dialogId, Data::Control control, bool useIdForPixmap)
+static Widget convertChildWidget(const Data &data, const QString &dialogId, const Data::Control &control,
+                                 bool useIdForPixmap)
 {
+    // The conversion consumes the styles once handled, the control itself is not changed
+    QStringList styles = control.styles;
     Widget widget;
 
     auto type = static_cast<Keywords>(control.type);
@@ -613,41 +616,41 @@ static Widget convertChildWidget(const Data &data, const QString &dialogId, Data
     case Keywords::DEFPUSHBUTTON:
     case Keywords::PUSHBOX:
     case Keywords::PUSHBUTTON:
-        widget = convertPushButton(data, dialogId, control);
+        widget = convertPushButton(data, dialogId, control, styles);
         break;
     case Keywords::AUTORADIOBUTTON:
     case Keywords::RADIOBUTTON:
-        widget = convertRadioButton(data, control);
+        widget = convertRadioButton(data, control, styles);
         break;
     case Keywords::AUTO3STATE:
     case Keywords::AUTOCHECKBOX:
     case Keywords::CHECKBOX:
     case Keywords::STATE3:
-        widget = convertCheckBox(data, control);
+        widget = convertCheckBox(data, control, styles);
         break;
     case Keywords::COMBOBOX:
-        widget = convertComboBox(data, dialogId, control);
+        widget = convertComboBox(data, dialogId, control, styles);
         break;
     case Keywords::CTEXT:
     case Keywords::LTEXT:
     case Keywords::RTEXT:
     case Keywords::ICON:
-        widget = convertLabel(data, control, useIdForPixmap);
+        widget = convertLabel(data, control, styles, useIdForPixmap);
         break;
     case Keywords::EDITTEXT:
-        widget = convertEditText(data, control);
+        widget = convertEditText(data, control, styles);
         break;
     case Keywords::GROUPBOX:
-        widget = convertGroupBox(data, control);
+        widget = convertGroupBox(data, control, styles);
         break;
     case Keywords::LISTBOX:
-        widget = convertListWidget(data, control);
+        widget = convertListWidget(data, control, styles);
         break;
     case Keywords::SCROLLBAR:
-        widget = convertScrollBar(data, control);
+        widget = convertScrollBar(data, control, styles);
         break;
     case Keywords::CONTROL:
-        widget = convertControl(data, dialogId, control, useIdForPixmap);
+        widget = convertControl(data, dialogId, control, styles, useIdForPixmap);
         break;
     default:
         spdlog::error("{}({}): unknown control type {}", data.fileName, control.line,
@@ -655,12 +658,14 @@ static Widget convertChildWidget(const Data &data, const QString &dialogId, Data
     }
 
     widget.id = control.id;
-    widget.geometry = control.geometry;
+    // The geometry may have been adjusted by the conversion
+    if (widget.geometry.isNull())
+        widget.geometry = control.geometry;
 
     return widget;
 }
 
-static QList<Widget> adjustHierarchy(QList<Widget> widgets)
+static QList<Widget> adjustHierarchy(QList<Widget> &&widgets)
 {
     if (widgets.isEmpty())
         return {};
@@ -676,7 +681,7 @@ static QList<Widget> adjustHierarchy(QList<Widget> widgets)
     for (int i = 0; i < widgets.size(); ++i) {
         bool isChildren = false;
         Widget iWidget = std::move(widgets[i]);
-        QRect geomi = widgets.at(i).geometry;
+        QRect geomi = iWidget.geometry;
 
         // Check if the widget is inside another one
         for (int j = i + 1; j < widgets.size(); ++j) {
@@ -711,18 +716,18 @@ void adjustGeometry(Widget &widget, double scaleX, double scaleY)
         adjustGeometry(child, scaleX, scaleY);
 }
 
-Widget convertDialog(const Data &data, const Data::Dialog &d, Widget::ConversionFlags flags, double scaleX,
+Widget convertDialog(const Data &data, const Data::Dialog &dialog, Widget::ConversionFlags flags, double scaleX,
                      double scaleY)
 {
-    Data::Dialog dialog = d;
-
     Widget widget;
     widget.id = dialog.id;
     widget.geometry = dialog.geometry;
 
+    // Styles are removed from the list once handled
+    QStringList styles = dialog.styles;
     if (dialog.menu.isEmpty()) {
         // If the dialog has a caption, it's a true Qt dialog, otherwise it's a widget
-        if (dialog.styles.removeOne("WS_CAPTION")) {
+        if (styles.removeOne("WS_CAPTION")) {
             widget.className = "QDialog";
         } else {
             widget.className = "QWidget";
@@ -736,12 +741,12 @@ Widget convertDialog(const Data &data, const Data::Dialog &d, Widget::Conversion
         widget.properties["windowTitle"] = dialog.caption;
     }
 
-    if (!dialog.styles.isEmpty()) {
-        spdlog::info("{}({}): {} has unused styles {}", data.fileName, dialog.line, dialog.id,
-                     dialog.styles.join(", "));
+    if (!styles.isEmpty()) {
+        spdlog::info("{}({}): {} has unused styles {}", data.fileName, dialog.line, dialog.id, styles.join(", "));
     }
 
-    for (const auto &control : std::as_const(dialog.controls)) {
+    widget.children.reserve(dialog.controls.size());
+    for (const auto &control : dialog.controls) {
         widget.children.push_back(convertChildWidget(data, dialog.id, control, flags & Widget::UseIdForPixmap));
     }
 
@@ -751,7 +756,7 @@ Widget convertDialog(const Data &data, const Data::Dialog &d, Widget::Conversion
     // The hierarchy update needs to be done after the geometry update
     // to ensure that combobox are well placed.
     if (flags & Widget::UpdateHierarchy)
-        widget.children = adjustHierarchy(widget.children);
+        widget.children = adjustHierarchy(std::move(widget.children));
 
     return widget;
 }
@@ -13,13 +13,25 @@
 #include "stream.h"
 #include "utils/log.h"
 
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
 #include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 #include <QHash>
 #include <QKeySequence>
+#include <QSaveFile>
+#include <QStringTokenizer>
 #include <QTextStream>
+#include <QtConcurrent>
+#include <algorithm>
+#include <array>
 #include <kdalgorithms.h>
+#include <limits>
+
+using namespace Qt::Literals::StringLiterals;
 
 namespace RcCore {
 
@@ -62,6 +74,38 @@ static std::optional<QString> computeFilePath(const QString &absolutePath, const
     return {};
 }
 
+static QByteArray fileHash(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+    return hash.result();
+}
+
+static QHash<QString, QByteArray> computeIncludeHashes(const RcFile &rcFile)
+{
+    QHash<QString, QByteArray> includeHashes;
+    for (const auto &include : rcFile.includes) {
+        if (include.exist)
+            includeHashes[include.fileName] = fileHash(include.fileName);
+    }
+    return includeHashes;
+}
+
+// Check that the included files are the same as when the RC file was parsed
+static bool areIncludesUpToDate(const RcFile &rcFile)
+{
+    for (const auto &include : rcFile.includes) {
+        if (include.exist != computeFilePath(rcFile.fileName, include.fileName).has_value())
+            return false;
+        if (include.exist && rcFile.includeHashes.value(include.fileName) != fileHash(include.fileName))
+            return false;
+    }
+    return true;
+}
+
 static QHash<int, QString> loadResourceFile(const QString &resourceFile)
 {
     QFile file(resourceFile);
@@ -69,23 +113,36 @@ static QHash<int, QString> loadResourceFile(const QString &resourceFile)
         return {};
 
     QTextStream stream(&file);
+    const QString content = stream.readAll();
+
+    // Only lines like `#define ID_VALUE 1234` are handled, the fields are read without any allocation
     QHash<int, QString> resourceMap;
-    static QRegularExpression empty_spaces("\\s+");
-    while (!stream.atEnd()) {
-        const QString line = stream.readLine();
-        if (!line.startsWith("#define"))
+    for (const auto line : QStringTokenizer(content, u'\n')) {
+        if (!line.startsWith(u"#define"))
             continue;
 
-        QStringList fields = line.split(empty_spaces, Qt::SkipEmptyParts);
-        if (fields.size() < 3)
+        // Split the line on whitespaces, only the first 3 fields are needed
+        std::array<QStringView, 3> fields;
+        qsizetype count = 0;
+        qsizetype start = -1;
+        for (qsizetype i = 0; i <= line.size() && count < 3; ++i) {
+            const bool isSpace = i == line.size() || line.at(i).isSpace();
+            if (isSpace && start != -1) {
+                fields[count++] = line.mid(start, i - start);
+                start = -1;
+            } else if (!isSpace && start == -1) {
+                start = i;
+            }
+        }
+        if (count < 3)
             continue;
-        const auto &value = fields.at(1);
+
         bool ok;
-        const int key = fields.at(2).toInt(&ok);
+        const int key = fields[2].toInt(&ok);
         if (!ok)
             continue;
 
-        resourceMap[key] = value;
+        resourceMap[key] = fields[1].toString();
     }
     return resourceMap;
 }
@@ -1396,22 +1453,80 @@ static void readDirective(Context &context, const QString &directive)
 //=============================================================================
 // RcFileUtils::parse
 //=============================================================================
-RcFile parse(const QString &fileName)
+// Part of the RC file content, from `from` to `to`, starting at line `line`
+struct Section
 {
-    QElapsedTimer time;
-    time.start();
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly))
-        return {};
+    int from = 0;
+    int to = 0;
+    int line = 1;
+    bool hasHeaderInclude = false;
+};
 
-    RcFile rcFile;
-    rcFile.fileName = fileName;
+// Split the content in sections, each new section starting with a top-level LANGUAGE statement, so they can be
+// parsed in parallel. A LANGUAGE statement starts a new section only if it's outside of any BEGIN/END block and
+// directly follows the end of a block (ignoring comments and directives): this ensures it's not an optional statement
+// of a resource. This is done on lines, without lexing the content.
+// A section including a header file is flagged, as it could change the ids used by the following sections.
+static QList<Section> splitLanguageSections(const QString &content)
+{
+    QList<Section> sections = {{}};
+    int depth = 0;
+    bool afterBlock = true;
+    int line = 1;
+    int pos = 0;
+    while (pos < content.size()) {
+        int end = static_cast<int>(content.indexOf('\n', pos));
+        if (end == -1)
+            end = static_cast<int>(content.size());
+
+        const QStringView text = QStringView(content).mid(pos, end - pos).trimmed();
+        qsizetype wordSize = 0;
+        while (wordSize < text.size() && (text.at(wordSize).isLetterOrNumber() || text.at(wordSize) == '_'))
+            ++wordSize;
+        const QStringView word = text.first(wordSize);
+
+        if (text.startsWith(u"#include")) {
+            if (text.contains(u".h\"") || text.contains(u".h>"))
+                sections.last().hasHeaderInclude = true;
+        } else if (text.isEmpty() || text.startsWith(u"//") || text.startsWith(u'#')) {
+            // Nothing to do, comments and other directives are ignored
+        } else if (word == "BEGIN"_L1) {
+            ++depth;
+            afterBlock = false;
+        } else if (word == "END"_L1) {
+            depth = std::max(depth - 1, 0);
+            afterBlock = (depth == 0);
+        } else if (word == "LANGUAGE"_L1 && depth == 0 && afterBlock) {
+            sections.last().to = pos;
+            sections.push_back({pos, 0, line});
+            afterBlock = false;
+        } else {
+            afterBlock = false;
+        }
+
+        pos = end + 1;
+        ++line;
+    }
+    sections.last().to = static_cast<int>(content.size());
+    return sections;
+}
 
-    Lexer lexer(Stream {&file});
-    lexer.setFileName(fileName);
-    rcFile.content = lexer.content();
+// Parse the section, recording the top-level blocks. If `language` is set, the section is parsed as if it was preceded
+// by this LANGUAGE statement.
+static bool parseSection(RcFile &rcFile, const Section &section, const QString &language = {})
+{
+    Lexer lexer(Stream {rcFile.content, section.from, section.to, section.line});
+    lexer.setFileName(rcFile.fileName);
 
     Context context = {.rcFile = rcFile, .lexer = lexer};
+    if (!language.isEmpty())
+        context.setCurrentData(language);
+
+    int blockFrom = 0;
+    int blockLine = 1;
+    auto addBlock = [&](RcFile::Block::Kind kind) {
+        rcFile.blocks.push_back({kind, blockFrom, blockLine, context.currentLanguage});
+    };
 
     try {
         std::optional<Token> previousToken;
@@ -1430,13 +1545,24 @@ RcFile parse(const QString &fileName)
                 if (previousToken) {
                     spdlog::error("{}({}): parser error on token {}", context.fileName(), context.line(),
                                   token->prettyPrint());
+                } else {
+                    blockFrom = lexer.tokenPosition();
+                    blockLine = lexer.tokenLine();
                 }
                 previousToken = token;
                 break;
             case Token::Directive:
+                blockFrom = lexer.tokenPosition();
+                blockLine = lexer.tokenLine();
+                addBlock(token->toString() == "include" ? RcFile::Block::Include : RcFile::Block::Directive);
                 readDirective(context, token->toString());
                 break;
             case Token::Keyword: {
+                if (!previousToken) {
+                    blockFrom = lexer.tokenPosition();
+                    blockLine = lexer.tokenLine();
+                }
+                addBlock(token->toKeyword() == Keywords::LANGUAGE ? RcFile::Block::Language : RcFile::Block::Resource);
                 readResource(context, token, previousToken);
                 previousToken.reset();
                 break;
@@ -1445,11 +1571,600 @@ RcFile parse(const QString &fileName)
         }
     } catch (...) {
         spdlog::critical("{}({}): parser general error", context.fileName(), context.line());
+        return false;
+    }
+    return true;
+}
+
+// Parse each language section in parallel, and merge the results in the file order
+static bool parseSectionsConcurrently(RcFile &rcFile, const QList<Section> &sections)
+{
+    // The first section contains the includes, and so the resource map used by the other sections
+    if (!parseSection(rcFile, sections.first()))
+        return false;
+
+    QList<RcFile> parts = QtConcurrent::blockingMapped(sections.sliced(1), [&rcFile](const Section &section) {
+        RcFile part;
+        part.fileName = rcFile.fileName;
+        part.content = rcFile.content;
+        part.resourceMap = rcFile.resourceMap;
+        part.isValid = parseSection(part, section);
+        return part;
+    });
+
+    for (const auto &part : std::as_const(parts)) {
+        if (!part.isValid)
+            return false;
+    }
+
+    for (auto &part : parts) {
+        rcFile.includes.append(std::move(part.includes));
+        rcFile.blocks.append(std::move(part.blocks));
+        for (auto it = part.data.begin(); it != part.data.end(); ++it) {
+            if (rcFile.data.contains(it.key()))
+                rcFile.data[it.key()].append(std::move(it.value()));
+            else
+                rcFile.data.insert(it.key(), std::move(it.value()));
+        }
+    }
+    return true;
+}
+
+static RcFile parseContent(const QString &fileName, const QString &content, ParseMode mode = ParseMode::Auto)
+{
+    QElapsedTimer time;
+    time.start();
+
+    RcFile rcFile;
+    rcFile.fileName = fileName;
+    rcFile.content = content;
+
+    const QList<Section> sections = splitLanguageSections(rcFile.content);
+    // The first section is before any LANGUAGE statement, only use threads if there are multiple languages
+    // A header included in a language section changes the ids of the following sections: parse sequentially
+    const bool hasHeaderInclude = std::any_of(sections.cbegin() + 1, sections.cend(), [](const Section &section) {
+        return section.hasHeaderInclude;
+    });
+    const bool concurrent = mode == ParseMode::Auto && sections.size() > 2 && !hasHeaderInclude;
+    const bool success = concurrent ? parseSectionsConcurrently(rcFile, sections)
+                                    : parseSection(rcFile, {0, static_cast<int>(rcFile.content.size()), 1});
+    if (!success)
         return {};
+
+    for (auto &data : rcFile.data)
+        data.updateIndexes();
+    rcFile.includeHashes = computeIncludeHashes(rcFile);
+
+    spdlog::trace("{} ms for parsing {}", static_cast<int>(time.elapsed()), fileName);
+    rcFile.isValid = true;
+    return rcFile;
+}
+
+static RcFile parse(const QString &fileName, QIODevice *device, ParseMode mode = ParseMode::Auto)
+{
+    return parseContent(fileName, Stream {device}.content(), mode);
+}
+
+RcFile parse(const QString &fileName, ParseMode mode)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return parse(fileName, &file, mode);
+}
+
+//=============================================================================
+// Incremental parsing
+//=============================================================================
+template <typename T>
+static void shiftLines(T &item, int delta)
+{
+    item.line += delta;
+}
+
+static void shiftLines(ToolBar &toolBar, int delta)
+{
+    toolBar.line += delta;
+    for (auto &child : toolBar.children)
+        child.line += delta;
+}
+
+static void shiftLines(MenuItem &item, int delta)
+{
+    item.line += delta;
+    for (auto &child : item.children)
+        shiftLines(child, delta);
+}
+
+static void shiftLines(Menu &menu, int delta)
+{
+    menu.line += delta;
+    for (auto &child : menu.children)
+        shiftLines(child, delta);
+}
+
+static void shiftLines(Data::AcceleratorTable &table, int delta)
+{
+    table.line += delta;
+    for (auto &accelerator : table.accelerators)
+        accelerator.line += delta;
+}
+
+static void shiftLines(Data::Dialog &dialog, int delta)
+{
+    dialog.line += delta;
+    for (auto &control : dialog.controls)
+        control.line += delta;
+}
+
+// Shift the lines of all items starting at or after `line`
+template <typename T>
+static void shiftListLines(QList<T> &list, int line, int delta)
+{
+    for (auto &item : list) {
+        if (item.line >= line)
+            shiftLines(item, delta);
     }
-    spdlog::trace("{} ms for parsing {}", static_cast<int>(time.elapsed()), context.fileName());
+}
+
+static void shiftDataLines(Data &data, int line, int delta)
+{
+    shiftListLines(data.icons, line, delta);
+    shiftListLines(data.assets, line, delta);
+    shiftListLines(data.acceleratorTables, line, delta);
+    shiftListLines(data.menus, line, delta);
+    shiftListLines(data.toolBars, line, delta);
+    shiftListLines(data.dialogDataList, line, delta);
+    shiftListLines(data.dialogs, line, delta);
+    shiftListLines(data.ribbons, line, delta);
+    for (auto &string : data.strings) {
+        if (string.line >= line)
+            string.line += delta;
+    }
+}
+
+// Replace the items of `list` between lines [lineFrom, lineTo) by `items`, and shift the lines of the following ones.
+// The items of one language are sorted by lines, as they are added in the file order, but the list may contain
+// multiple merged languages: the new items are inserted after the closest item before lineFrom.
+template <typename T>
+static void spliceList(QList<T> &list, QList<T> &&items, int lineFrom, int lineTo, int delta)
+{
+    qsizetype insertAt = 0;
+    int closestLine = std::numeric_limits<int>::min();
+    for (qsizetype i = 0; i < list.size(); ++i) {
+        if (list.at(i).line < lineFrom && list.at(i).line > closestLine) {
+            closestLine = list.at(i).line;
+            insertAt = i + 1;
+        }
+    }
+
+    QList<T> result;
+    result.reserve(list.size() + items.size());
+    for (qsizetype i = 0; i < list.size(); ++i) {
+        if (i == insertAt)
+            result.append(std::move(items));
+        auto &item = list[i];
+        if (item.line >= lineFrom && item.line < lineTo)
+            continue;
+        if (item.line >= lineTo)
+            shiftLines(item, delta);
+        result.push_back(std::move(item));
+    }
+    if (insertAt == list.size())
+        result.append(std::move(items));
+    list = std::move(result);
+}
+
+static void spliceData(Data &data, Data &&newData, int lineFrom, int lineTo, int delta)
+{
+    spliceList(data.icons, std::move(newData.icons), lineFrom, lineTo, delta);
+    spliceList(data.assets, std::move(newData.assets), lineFrom, lineTo, delta);
+    spliceList(data.acceleratorTables, std::move(newData.acceleratorTables), lineFrom, lineTo, delta);
+    spliceList(data.menus, std::move(newData.menus), lineFrom, lineTo, delta);
+    spliceList(data.toolBars, std::move(newData.toolBars), lineFrom, lineTo, delta);
+    spliceList(data.dialogDataList, std::move(newData.dialogDataList), lineFrom, lineTo, delta);
+    spliceList(data.dialogs, std::move(newData.dialogs), lineFrom, lineTo, delta);
+    spliceList(data.ribbons, std::move(newData.ribbons), lineFrom, lineTo, delta);
+
+    data.strings.removeIf([lineFrom, lineTo](const std::pair<const QString &, String &> &it) {
+        return it.second.line >= lineFrom && it.second.line < lineTo;
+    });
+    for (auto &string : data.strings) {
+        if (string.line >= lineTo)
+            string.line += delta;
+    }
+    data.strings.insert(newData.strings);
+
+    data.updateIndexes();
+}
+
+/**
+ * @brief Update `rcFile` for its new `content`, parsing again only the top-level blocks touched by the change
+ * The changed blocks are parsed again, with the block before and the block after, and the result is spliced into the
+ * existing data, even if its languages have been merged. If the change touches a LANGUAGE statement or an include, if
+ * an included file has changed, or if the block boundaries are not the same after the change, the whole content is
+ * parsed again, and the languages are not merged anymore.
+ * Returns true if the update was done incrementally.
+ */
+bool reparse(RcFile &rcFile, const QString &content)
+{
+    QElapsedTimer time;
+    time.start();
+
+    auto parseAll = [&rcFile, &content]() {
+        rcFile = parseContent(rcFile.fileName, content);
+        return false;
+    };
+
+    // An included file may change the ids, like resource.h
+    if (!rcFile.isValid || rcFile.blocks.isEmpty() || !areIncludesUpToDate(rcFile))
+        return parseAll();
+
+    // Find the changed range, from the common prefix and suffix
+    const QString oldContent = rcFile.content;
+    const qsizetype minSize = std::min(oldContent.size(), content.size());
+    qsizetype prefix = 0;
+    while (prefix < minSize && oldContent.at(prefix) == content.at(prefix))
+        ++prefix;
+    if (prefix == oldContent.size() && prefix == content.size())
+        return true;
+    qsizetype suffix = 0;
+    while (suffix < minSize - prefix
+           && oldContent.at(oldContent.size() - suffix - 1) == content.at(content.size() - suffix - 1))
+        ++suffix;
+    const qsizetype oldEnd = oldContent.size() - suffix;
+    const qsizetype newEnd = content.size() - suffix;
+    const int delta = static_cast<int>(content.size() - oldContent.size());
+    const int lineDelta = static_cast<int>(QStringView(content).sliced(prefix, newEnd - prefix).count(u'\n')
+                                           - QStringView(oldContent).sliced(prefix, oldEnd - prefix).count(u'\n'));
+
+    // Find the blocks to parse again: a block ends where the next one starts
+    const QList<RcFile::Block> &blocks = rcFile.blocks;
+    auto blockAt = [&blocks](qsizetype pos) {
+        return std::ranges::upper_bound(blocks, pos, {}, &RcFile::Block::from) - blocks.begin() - 1;
+    };
+    const qsizetype changed = blockAt(prefix - 1);
+    if (changed < 0)
+        return parseAll();
+    const QString language = blocks.at(changed).language;
+    const QString dataLanguage = rcFile.mergedLanguages.value(language, language);
+    auto isResource = [&language](const RcFile::Block &block) {
+        return (block.kind == RcFile::Block::Resource || block.kind == RcFile::Block::Directive)
+            && block.language == language;
+    };
+
+    // The end of a block may depend on the first tokens of the next one, so the previous block is parsed too
+    const qsizetype first = changed > 0 && isResource(blocks.at(changed - 1)) ? changed - 1 : changed;
+    // The block following the change is parsed too, to check that the block boundaries are unchanged, except if it's
+    // a LANGUAGE statement or an include, which always start a new block
+    const qsizetype guard = blockAt(oldEnd) + 1;
+    const bool hasGuard = guard < blocks.size() && isResource(blocks.at(guard));
+    const qsizetype end = hasGuard ? guard + 1 : guard;
+    if (language.isEmpty() || !rcFile.data.contains(dataLanguage)
+        || !std::all_of(blocks.cbegin() + first, blocks.cbegin() + end, isResource))
+        return parseAll();
+
+    RcFile part;
+    part.fileName = rcFile.fileName;
+    part.content = content;
+    part.resourceMap = rcFile.resourceMap;
+    const int to = end < blocks.size() ? blocks.at(end).from + delta : static_cast<int>(content.size());
+    if (!parseSection(part, {blocks.at(first).from, to, blocks.at(first).line}, language))
+        return parseAll();
+
+    if (!std::ranges::all_of(part.blocks, isResource))
+        return parseAll();
+    if (hasGuard) {
+        if (part.blocks.isEmpty() || part.blocks.last().from != blocks.at(guard).from + delta
+            || part.blocks.last().line != blocks.at(guard).line + lineDelta)
+            return parseAll();
+    }
+
+    // Splice the new data, and shift the lines of everything after
+    const int lineFrom = blocks.at(first).line;
+    const int lineTo = end < blocks.size() ? blocks.at(end).line : std::numeric_limits<int>::max();
+    for (auto it = rcFile.data.begin(); it != rcFile.data.end(); ++it) {
+        if (it.key() == dataLanguage)
+            spliceData(it.value(), part.data.take(language), lineFrom, lineTo, lineDelta);
+        else
+            shiftDataLines(it.value(), lineTo, lineDelta);
+    }
+    for (auto &include : rcFile.includes) {
+        if (include.line >= lineTo)
+            include.line += lineDelta;
+    }
+
+    QList<RcFile::Block> newBlocks = blocks.first(first);
+    newBlocks.append(std::move(part.blocks));
+    for (auto block : blocks.sliced(end)) {
+        block.from += delta;
+        block.line += lineDelta;
+        newBlocks.push_back(block);
+    }
+    rcFile.blocks = std::move(newBlocks);
+    rcFile.content = content;
+
+    spdlog::trace("{} ms for parsing {} blocks of {}", static_cast<int>(time.elapsed()), end - first, rcFile.fileName);
+    return true;
+}
+
+//=============================================================================
+// Snapshots
+//=============================================================================
+// Snapshots are a binary serialization of the RcFile structure, stored in a cache directory.
+// A snapshot file name is the hash of the RC file path, so there's only one snapshot per RC file. The snapshot itself
+// stores the hash of the RC file content and of all the included files, so it can be discarded if one of them has
+// changed.
+// Increase the version each time the structures in data.h are changed.
+constexpr quint32 SnapshotMagic = 0x4b524353; // KRCS
+constexpr qint32 SnapshotVersion = 3;
+
+static QDataStream &operator<<(QDataStream &out, const Asset &asset)
+{
+    return out << asset.id << asset.fileName << asset.exist << asset.line << asset.originalFileName << asset.iconRect;
+}
+
+static QDataStream &operator>>(QDataStream &in, Asset &asset)
+{
+    return in >> asset.id >> asset.fileName >> asset.exist >> asset.line >> asset.originalFileName >> asset.iconRect;
+}
+
+static QDataStream &operator<<(QDataStream &out, const ToolBarItem &item)
+{
+    return out << item.id << item.line;
+}
+
+static QDataStream &operator>>(QDataStream &in, ToolBarItem &item)
+{
+    return in >> item.id >> item.line;
+}
+
+static QDataStream &operator<<(QDataStream &out, const ToolBar &toolBar)
+{
+    return out << toolBar.id << toolBar.iconSize << toolBar.children << toolBar.line;
+}
+
+static QDataStream &operator>>(QDataStream &in, ToolBar &toolBar)
+{
+    return in >> toolBar.id >> toolBar.iconSize >> toolBar.children >> toolBar.line;
+}
+
+static QDataStream &operator<<(QDataStream &out, const MenuItem &item)
+{
+    return out << item.id << item.text << item.children << item.isTopLevel << item.shortcut << item.flags
+               << item.line;
+}
+
+static QDataStream &operator>>(QDataStream &in, MenuItem &item)
+{
+    return in >> item.id >> item.text >> item.children >> item.isTopLevel >> item.shortcut >> item.flags >> item.line;
+}
+
+static QDataStream &operator<<(QDataStream &out, const Menu &menu)
+{
+    return out << menu.id << menu.children << menu.line;
+}
+
+static QDataStream &operator>>(QDataStream &in, Menu &menu)
+{
+    return in >> menu.id >> menu.children >> menu.line;
+}
+
+static QDataStream &operator<<(QDataStream &out, const String &string)
+{
+    return out << string.id << string.text << string.line;
+}
+
+static QDataStream &operator>>(QDataStream &in, String &string)
+{
+    return in >> string.id >> string.text >> string.line;
+}
+
+// Only the data coming from the RC file are stored, the ribbon content is loaded on demand
+static QDataStream &operator<<(QDataStream &out, const Ribbon &ribbon)
+{
+    return out << ribbon.id << ribbon.line << ribbon.fileName;
+}
+
+static QDataStream &operator>>(QDataStream &in, Ribbon &ribbon)
+{
+    return in >> ribbon.id >> ribbon.line >> ribbon.fileName;
+}
+
+static QDataStream &operator<<(QDataStream &out, const Data::Include &include)
+{
+    return out << include.line << include.fileName << include.exist;
+}
+
+static QDataStream &operator>>(QDataStream &in, Data::Include &include)
+{
+    return in >> include.line >> include.fileName >> include.exist;
+}
+
+static QDataStream &operator<<(QDataStream &out, const Data::DialogData &dialogData)
+{
+    return out << dialogData.line << dialogData.id << dialogData.values;
+}
+
+static QDataStream &operator>>(QDataStream &in, Data::DialogData &dialogData)
+{
+    return in >> dialogData.line >> dialogData.id >> dialogData.values;
+}
+
+static QDataStream &operator<<(QDataStream &out, const Data::Accelerator &accelerator)
+{
+    return out << accelerator.line << accelerator.id << accelerator.shortcut;
+}
+
+static QDataStream &operator>>(QDataStream &in, Data::Accelerator &accelerator)
+{
+    return in >> accelerator.line >> accelerator.id >> accelerator.shortcut;
+}
+
+static QDataStream &operator<<(QDataStream &out, const Data::AcceleratorTable &table)
+{
+    return out << table.line << table.id << table.accelerators;
+}
+
+static QDataStream &operator>>(QDataStream &in, Data::AcceleratorTable &table)
+{
+    return in >> table.line >> table.id >> table.accelerators;
+}
+
+static QDataStream &operator<<(QDataStream &out, const Data::Control &control)
+{
+    return out << control.line << control.type << control.text << control.id << control.className << control.geometry
+               << control.styles;
+}
+
+static QDataStream &operator>>(QDataStream &in, Data::Control &control)
+{
+    return in >> control.line >> control.type >> control.text >> control.id >> control.className >> control.geometry
+        >> control.styles;
+}
+
+static QDataStream &operator<<(QDataStream &out, const Data::Dialog &dialog)
+{
+    return out << dialog.line << dialog.id << dialog.geometry << dialog.caption << dialog.menu << dialog.styles
+               << dialog.controls;
+}
+
+static QDataStream &operator>>(QDataStream &in, Data::Dialog &dialog)
+{
+    return in >> dialog.line >> dialog.id >> dialog.geometry >> dialog.caption >> dialog.menu >> dialog.styles
+        >> dialog.controls;
+}
+
+static QDataStream &operator<<(QDataStream &out, const Data &data)
+{
+    return out << data.fileName << data.language << data.icons << data.assets << data.strings << data.acceleratorTables
+               << data.menus << data.toolBars << data.dialogDataList << data.dialogs << data.ribbons;
+}
+
+static QDataStream &operator>>(QDataStream &in, Data &data)
+{
+    return in >> data.fileName >> data.language >> data.icons >> data.assets >> data.strings >> data.acceleratorTables
+        >> data.menus >> data.toolBars >> data.dialogDataList >> data.dialogs >> data.ribbons;
+}
+
+static QDataStream &operator<<(QDataStream &out, const RcFile::Block &block)
+{
+    return out << static_cast<qint32>(block.kind) << block.from << block.line << block.language;
+}
+
+static QDataStream &operator>>(QDataStream &in, RcFile::Block &block)
+{
+    qint32 kind;
+    in >> kind >> block.from >> block.line >> block.language;
+    block.kind = static_cast<RcFile::Block::Kind>(kind);
+    return in;
+}
+
+static QString snapshotFileName(const QString &cacheDir, const QString &fileName)
+{
+    const auto hash =
+        QCryptographicHash::hash(QFileInfo(fileName).absoluteFilePath().toUtf8(), QCryptographicHash::Sha1);
+    return QStringLiteral("%1/%2.rcs").arg(cacheDir, QString::fromLatin1(hash.toHex()));
+}
+
+// Check that the files referenced in the RC file are still the same: same includes, and same existing assets
+static bool isSnapshotUpToDate(const RcFile &rcFile)
+{
+    if (!areIncludesUpToDate(rcFile))
+        return false;
+
+    auto isAssetUpToDate = [&rcFile](const Asset &asset) {
+        const auto fullPath = computeFilePath(rcFile.fileName, asset.fileName);
+        return asset.exist == fullPath.has_value() && (!asset.exist || fullPath.value() == asset.fileName);
+    };
+    for (const auto &data : rcFile.data) {
+        if (!std::ranges::all_of(data.icons, isAssetUpToDate) || !std::ranges::all_of(data.assets, isAssetUpToDate))
+            return false;
+    }
+    return true;
+}
+
+static std::optional<RcFile> readSnapshot(const QString &snapshotFileName, const QByteArray &contentHash)
+{
+    QFile file(snapshotFileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    QDataStream in(&file);
+    quint32 magic;
+    qint32 version;
+    in >> magic >> version;
+    if (magic != SnapshotMagic || version != SnapshotVersion)
+        return {};
+    in.setVersion(QDataStream::Qt_6_0);
+
+    QByteArray snapshotContentHash;
+    in >> snapshotContentHash;
+    if (in.status() != QDataStream::Ok || snapshotContentHash != contentHash)
+        return {};
+
+    RcFile rcFile;
+    in >> rcFile.includeHashes >> rcFile.fileName >> rcFile.content >> rcFile.includes >> rcFile.resourceMap
+        >> rcFile.data >> rcFile.blocks;
+    if (in.status() != QDataStream::Ok)
+        return {};
+    if (!isSnapshotUpToDate(rcFile))
+        return {};
+
+    for (auto &data : rcFile.data)
+        data.updateIndexes();
+
     rcFile.isValid = true;
     return rcFile;
 }
 
+static void writeSnapshot(const RcFile &rcFile, const QString &snapshotFileName, const QByteArray &contentHash)
+{
+    QDir().mkpath(QFileInfo(snapshotFileName).absolutePath());
+    QSaveFile file(snapshotFileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        spdlog::warn("{}: can't write snapshot {}", FUNCTION_NAME, snapshotFileName);
+        return;
+    }
+
+    QDataStream out(&file);
+    out << SnapshotMagic << SnapshotVersion;
+    out.setVersion(QDataStream::Qt_6_0);
+    out << contentHash << rcFile.includeHashes << rcFile.fileName << rcFile.content << rcFile.includes
+        << rcFile.resourceMap << rcFile.data << rcFile.blocks;
+    if (out.status() != QDataStream::Ok || !file.commit())
+        spdlog::warn("{}: can't write snapshot {}", FUNCTION_NAME, snapshotFileName);
+}
+
+/**
+ * @brief Parse a RC file, using a snapshot stored in `cacheDir` if possible
+ * The snapshot is used only if the RC file and all its includes are unchanged, otherwise the RC file is parsed and
+ * the snapshot in `cacheDir` is replaced.
+ */
+RcFile parse(const QString &fileName, const QString &cacheDir)
+{
+    QElapsedTimer time;
+    time.start();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    const QByteArray content = file.readAll();
+
+    const QString snapshot = snapshotFileName(cacheDir, fileName);
+    const QByteArray contentHash = QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+    if (auto rcFile = readSnapshot(snapshot, contentHash); rcFile && rcFile->fileName == fileName) {
+        spdlog::trace("{} ms for reading snapshot of {}", static_cast<int>(time.elapsed()), fileName);
+        return rcFile.value();
+    }
+
+    QBuffer buffer;
+    buffer.setData(content);
+    buffer.open(QIODevice::ReadOnly);
+    RcFile rcFile = parse(fileName, &buffer);
+    if (rcFile.isValid)
+        writeSnapshot(rcFile, snapshot, contentHash);
+    return rcFile;
+}
+
 } // namespace RcCore
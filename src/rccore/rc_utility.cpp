@@ -17,27 +17,25 @@ void RcFile::mergeLanguages(const QStringList &languages, const QString &newLang
     if (languages.isEmpty() || (languages.count() == 1 && languages.first() == newLanguage))
         return;
 
-    Data newData = data.value(newLanguage, {});
+    // The data of each language is moved into the new data, and removed right away: resources are never copied
+    Data newData = data.take(newLanguage);
     newData.language = newLanguage;
     newData.fileName = fileName;
 
-    for (const auto &d : std::as_const(data)) {
-        if (!languages.contains(d.language))
+    for (const auto &language : languages) {
+        if (language == newLanguage || !data.contains(language))
             continue;
-        newData.acceleratorTables.append(d.acceleratorTables);
-        newData.assets.append(d.assets);
-        newData.dialogDataList.append(d.dialogDataList);
-        newData.dialogs.append(d.dialogs);
-        newData.icons.append(d.icons);
-        newData.menus.append(d.menus);
-        newData.strings.insert(d.strings);
-        newData.toolBars.append(d.toolBars);
-        newData.ribbons.append(d.ribbons);
+        newData.append(data.take(language));
+        mergedLanguages[language] = newLanguage;
+    }
+    // Languages merged before into one of the merged languages
+    for (auto &language : mergedLanguages) {
+        if (languages.contains(language))
+            language = newLanguage;
     }
 
-    for (const auto &lang : languages)
-        data.remove(lang);
-    data[newLanguage] = newData;
+    newData.updateIndexes();
+    data.insert(newLanguage, std::move(newData));
 }
 
 } // namespace RcCore
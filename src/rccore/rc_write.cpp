@@ -13,53 +13,160 @@
 #include "utils/qtuiwriter.h"
 
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QHash>
 #include <QIODevice>
 #include <QImage>
-#include <QSet>
+#include <QImageReader>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QSaveFile>
+#include <QThread>
 #include <QXmlStreamWriter>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 
 namespace RcCore {
 
 //=============================================================================
 // Asset writing
 //=============================================================================
-static QImage convertBmpImage(const Asset &asset, Asset::TransparentColors colors)
+// Replace the transparent colors by a fully transparent pixel.
+// Works directly on the scan lines, the loop is branch-free so the compiler can vectorize it.
+static void applyTransparentColors(QImage &image, const QList<QRgb> &colors)
 {
-    QImage image(asset.originalFileName);
+    if (colors.isEmpty())
+        return;
 
-    QSet<QRgb> transparentColors;
+    // Always compare against 3 colors, duplicating the first one if needed
+    const QRgb color0 = colors.value(0);
+    const QRgb color1 = colors.value(1, color0);
+    const QRgb color2 = colors.value(2, color0);
+
+    const int width = image.width();
+    for (int y = 0; y < image.height(); ++y) {
+        auto line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            const QRgb pixel = line[x];
+            const bool transparent = (pixel == color0) | (pixel == color1) | (pixel == color2);
+            line[x] = transparent ? 0 : pixel;
+        }
+    }
+}
+
+static QImage convertBmpImage(const QString &fileName, Asset::TransparentColors colors)
+{
+    QImage image(fileName);
+    if (image.isNull())
+        return image;
+
+    QList<QRgb> transparentColors;
     if (image.format() != QImage::Format_ARGB32) {
         if (colors & Asset::Gray)
-            transparentColors.insert(qRgb(192, 192, 192));
+            transparentColors.append(qRgb(192, 192, 192));
         if (colors & Asset::Magenta)
-            transparentColors.insert(qRgb(255, 0, 255));
+            transparentColors.append(qRgb(255, 0, 255));
         if (colors & Asset::BottomLeftPixel)
-            transparentColors.insert(image.pixel(0, image.height() - 1));
+            transparentColors.append(image.pixel(0, image.height() - 1));
     }
 
     image = image.convertToFormat(QImage::Format_ARGB32);
-    if (!transparentColors.isEmpty()) {
-        for (int x = 0; x < image.width(); ++x) {
-            for (int y = 0; y < image.height(); ++y) {
-                if (transparentColors.contains(image.pixel(x, y)))
-                    image.setPixel(x, y, qRgba(0, 0, 0, 0));
-            }
+    applyTransparentColors(image, transparentColors);
+    return image;
+}
+
+// Save the image atomically: the file is either fully written, or left untouched
+static bool saveImage(const QImage &image, const QString &fileName)
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    const QByteArray format = QFileInfo(fileName).suffix().toLatin1();
+    if (!image.save(&file, format.isEmpty() ? nullptr : format.constData())) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+// Sub-image sharing the pixels of `image`, nothing is copied: `image` must outlive the returned image
+static QImage subImage(const QImage &image, const QRect &rect)
+{
+    if (!image.rect().contains(rect))
+        return image.copy(rect);
+    const uchar *bits = image.constScanLine(rect.y()) + rect.x() * image.depth() / 8;
+    return QImage(bits, rect.width(), rect.height(), image.bytesPerLine(), image.format());
+}
+
+static QString sourceFileName(const Asset &asset)
+{
+    return asset.isSame() ? asset.fileName : asset.originalFileName;
+}
+
+// Only BMP images have transparent colors, other images are kept as they are
+static QImage decodeAssetImage(const QString &fileName, Asset::TransparentColors colors)
+{
+    if (QFileInfo(fileName).suffix().compare("bmp", Qt::CaseInsensitive) == 0)
+        return convertBmpImage(fileName, colors);
+    return QImage(fileName).convertToFormat(QImage::Format_ARGB32);
+}
+
+// All the assets coming from the same original image, the image is decoded only once
+struct AssetImageJob
+{
+    QString originalFileName;
+    QList<Asset> assets;
+};
+
+// The image is decoded, all its assets are encoded, and the image is released before the next job
+static bool writeAssetImageJob(const AssetImageJob &job, Asset::TransparentColors colors)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const QImage image = convertBmpImage(job.originalFileName, colors);
+    if (image.isNull()) {
+        spdlog::error("{}: can't read image {}", FUNCTION_NAME, job.originalFileName);
+        return false;
+    }
+    spdlog::debug("{}: {} decoded in {}ms", FUNCTION_NAME, job.originalFileName, timer.restart());
+
+    bool success = true;
+    for (const auto &asset : job.assets) {
+        // Write BMP -> PNG conversion, or BMP -> PNG for split toolbars
+        const bool saved = asset.iconRect.isNull() ? saveImage(image, asset.fileName)
+                                                   : saveImage(subImage(image, asset.iconRect), asset.fileName);
+        if (saved) {
+            spdlog::debug("{}: {} written in {}ms", FUNCTION_NAME, asset.fileName, timer.restart());
+        } else {
+            spdlog::error("{}: can't write image {}", FUNCTION_NAME, asset.fileName);
+            success = false;
         }
     }
-    return image;
+    return success;
 }
 
 /**
  * @brief Write new images for assets
  * Used if there's a BMP->PNG conversion, or toolbar splitting (default).
+ * Each original image is decoded once, the icons of split toolbars are sliced without copy, and images are converted
+ * and encoded in parallel.
  * @param assets list of assets
  * @param colors list of transparent colors for the conversion
+ * @return true if all images have been written
  */
-void writeAssetsToImage(const QList<Asset> &assets, Asset::TransparentColors colors)
+bool writeAssetsToImage(const QList<Asset> &assets, Asset::TransparentColors colors)
 {
-    QHash<QString, QImage> cache;
+    QElapsedTimer timer;
+    timer.start();
+
+    QList<AssetImageJob> jobs;
+    QHash<QString, qsizetype> jobIndex;
     for (const auto &asset : assets) {
         if (!asset.exist)
             continue;
@@ -67,20 +174,155 @@ void writeAssetsToImage(const QList<Asset> &assets, Asset::TransparentColors col
         if (asset.isSame())
             continue;
 
-        // Write BMP -> PNG conversion
-        if (asset.iconRect.isNull()) {
-            convertBmpImage(asset, colors).save(asset.fileName);
+        auto it = jobIndex.constFind(asset.originalFileName);
+        if (it == jobIndex.cend()) {
+            it = jobIndex.insert(asset.originalFileName, jobs.size());
+            jobs.push_back({asset.originalFileName, {}});
+        }
+        jobs[it.value()].assets.push_back(asset);
+    }
 
-            // Write BMP -> PNG for split toolbars
-        } else {
-            QImage image = cache.value(asset.originalFileName);
-            if (image.isNull()) {
-                image = convertBmpImage(asset, colors);
-                cache[asset.originalFileName] = image;
+    const QList<bool> results = QtConcurrent::blockingMapped(jobs, [colors](const AssetImageJob &job) {
+        return writeAssetImageJob(job, colors);
+    });
+
+    spdlog::debug("{}: {} images written in {}ms", FUNCTION_NAME, jobs.size(), timer.elapsed());
+    return !results.contains(false);
+}
+
+/**
+ * @brief Write all assets in a single atlas image, with a table of the icon coordinates
+ * Instead of writing one file per asset, the assets are packed in rows in the image `fileName`. The coordinates of
+ * each asset are written in a json file next to it, with the same base name.
+ * The icons are placed using the image sizes only, then the source images are decoded in small parallel batches, and
+ * released as soon as their icons are drawn.
+ * @param assets list of assets
+ * @param fileName file name of the atlas image
+ * @param colors list of transparent colors for the conversion of BMP images
+ * @return true if the atlas and the coordinate table have been written
+ */
+bool writeAssetsToAtlas(const QList<Asset> &assets, const QString &fileName, Asset::TransparentColors colors)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    struct AtlasIcon
+    {
+        QString id;
+        QRect sourceRect;
+        QPoint position;
+    };
+    QList<AtlasIcon> icons;
+    icons.reserve(assets.size());
+    // Icons of each source image, in the order of the assets
+    QStringList sourceFileNames;
+    QHash<QString, QList<qsizetype>> sourceIcons;
+    qint64 area = 0;
+    int maxWidth = 0;
+    for (const auto &asset : assets) {
+        if (!asset.exist)
+            continue;
+        const QString source = sourceFileName(asset);
+        QRect rect = asset.iconRect;
+        if (rect.isNull()) {
+            // Only read the image header
+            QImageReader reader(source);
+            QSize size = reader.size();
+            if (!size.isValid())
+                size = reader.read().size();
+            if (!size.isValid()) {
+                spdlog::error("{}: can't read image {}", FUNCTION_NAME, source);
+                return false;
             }
-            image.copy(asset.iconRect).save(asset.fileName);
+            rect = QRect(QPoint(0, 0), size);
+        }
+        auto it = sourceIcons.find(source);
+        if (it == sourceIcons.end()) {
+            it = sourceIcons.insert(source, {});
+            sourceFileNames.push_back(source);
         }
+        it->push_back(icons.size());
+        icons.push_back({asset.id, rect, {}});
+        area += static_cast<qint64>(rect.width()) * rect.height();
+        maxWidth = std::max(maxWidth, rect.width());
+    }
+
+    // Shelf packing: icons sorted by height are placed in rows, the atlas being roughly a square
+    QList<qsizetype> order(icons.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::stable_sort(order, std::greater {}, [&icons](qsizetype index) {
+        return icons.at(index).sourceRect.height();
+    });
+    const int atlasWidth = std::max(maxWidth, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(area)))));
+    int x = 0;
+    int y = 0;
+    int rowHeight = 0;
+    for (const auto index : std::as_const(order)) {
+        auto &icon = icons[index];
+        if (x + icon.sourceRect.width() > atlasWidth) {
+            x = 0;
+            y += rowHeight;
+            rowHeight = 0;
+        }
+        icon.position = {x, y};
+        x += icon.sourceRect.width();
+        rowHeight = std::max(rowHeight, icon.sourceRect.height());
+    }
+
+    QImage atlas(atlasWidth, std::max(y + rowHeight, 1), QImage::Format_ARGB32);
+    atlas.fill(Qt::transparent);
+    {
+        QPainter painter(&atlas);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        const qsizetype batchSize = std::max(QThread::idealThreadCount(), 1);
+        for (qsizetype start = 0; start < sourceFileNames.size(); start += batchSize) {
+            const QStringList batch = sourceFileNames.mid(start, batchSize);
+            const QList<QImage> images = QtConcurrent::blockingMapped(batch, [colors](const QString &source) {
+                return decodeAssetImage(source, colors);
+            });
+            for (qsizetype i = 0; i < batch.size(); ++i) {
+                if (images.at(i).isNull()) {
+                    spdlog::error("{}: can't read image {}", FUNCTION_NAME, batch.at(i));
+                    return false;
+                }
+                for (const auto index : sourceIcons.value(batch.at(i))) {
+                    const auto &icon = icons.at(index);
+                    painter.drawImage(icon.position, images.at(i), icon.sourceRect);
+                }
+            }
+        }
+    }
+
+    QJsonArray table;
+    for (const auto &icon : std::as_const(icons)) {
+        table.append(QJsonObject {{"id", icon.id},
+                                  {"x", icon.position.x()},
+                                  {"y", icon.position.y()},
+                                  {"width", icon.sourceRect.width()},
+                                  {"height", icon.sourceRect.height()}});
+    }
+
+    if (!saveImage(atlas, fileName)) {
+        spdlog::error("{}: can't write image {}", FUNCTION_NAME, fileName);
+        return false;
+    }
+
+    const QFileInfo fi(fileName);
+    const QString tableFileName = fi.absoluteDir().filePath(fi.completeBaseName() + ".json");
+    QSaveFile tableFile(tableFileName);
+    if (!tableFile.open(QIODevice::WriteOnly)) {
+        spdlog::error("{}: can't write file {}", FUNCTION_NAME, tableFileName);
+        return false;
+    }
+    const QJsonObject root {{"image", fi.fileName()}, {"icons", table}};
+    tableFile.write(QJsonDocument(root).toJson());
+    if (!tableFile.commit()) {
+        spdlog::error("{}: can't write file {}", FUNCTION_NAME, tableFileName);
+        return false;
     }
+
+    spdlog::debug("{}: {} icons written in {}ms", FUNCTION_NAME, icons.size(), timer.elapsed());
+    return true;
 }
 
 /**
@@ -140,6 +382,24 @@ static void writeWidget(Utils::QtUiWriter &writer, const Widget &widget, pugi::x
         writeWidget(writer, child, widgetNode);
 }
 
+// Write the xml document directly to the device, without intermediate string
+class DeviceXmlWriter : public pugi::xml_writer
+{
+public:
+    explicit DeviceXmlWriter(QIODevice *device)
+        : m_device(device)
+    {
+    }
+
+    void write(const void *data, size_t size) override
+    {
+        m_device->write(static_cast<const char *>(data), static_cast<qint64>(size));
+    }
+
+private:
+    QIODevice *m_device;
+};
+
 void writeDialogToUi(const Widget &widget, QIODevice *device)
 {
     pugi::xml_document doc;
@@ -147,7 +407,60 @@ void writeDialogToUi(const Widget &widget, QIODevice *device)
 
     writeWidget(writer, widget);
 
-    device->write(writer.dump().toUtf8());
+    DeviceXmlWriter xmlWriter(device);
+    doc.save(xmlWriter, "    ");
+}
+
+/**
+ * @brief Convert dialogs and write them as ui files
+ * The dialogs are converted and written in parallel, each ui file is written as soon as its dialog is converted.
+ * The ui file name is the dialog id, with the `.ui` extension.
+ * @param data data of the RC file
+ * @param dialogIds ids of the dialogs to write, all dialogs are written if empty
+ * @param path directory where the ui files are written
+ * @return true if all ui files have been written
+ */
+bool writeDialogsToUi(const Data &data, const QStringList &dialogIds, const QString &path,
+                      Widget::ConversionFlags flags, double scaleX, double scaleY)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QList<const Data::Dialog *> dialogs;
+    bool success = true;
+    if (dialogIds.isEmpty()) {
+        dialogs.reserve(data.dialogs.size());
+        for (const auto &dialog : data.dialogs)
+            dialogs.push_back(&dialog);
+    } else {
+        dialogs.reserve(dialogIds.size());
+        for (const auto &id : dialogIds) {
+            if (auto dialog = data.dialog(id)) {
+                dialogs.push_back(dialog);
+            } else {
+                spdlog::error("{}: unknown dialog {}", FUNCTION_NAME, id);
+                success = false;
+            }
+        }
+    }
+
+    const QList<bool> results = QtConcurrent::blockingMapped(dialogs, [&](const Data::Dialog *dialog) {
+        const QString fileName = QStringLiteral("%1/%2.ui").arg(path, dialog->id);
+        QSaveFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly)) {
+            spdlog::error("{}: can't write ui file {}", FUNCTION_NAME, fileName);
+            return false;
+        }
+        writeDialogToUi(convertDialog(data, *dialog, flags, scaleX, scaleY), &file);
+        if (!file.commit()) {
+            spdlog::error("{}: can't write ui file {}", FUNCTION_NAME, fileName);
+            return false;
+        }
+        return true;
+    });
+
+    spdlog::debug("{}: {} dialogs written in {}ms", FUNCTION_NAME, dialogs.size(), timer.elapsed());
+    return success && !results.contains(false);
 }
 
 } // namespace RcCore
@@ -27,15 +27,43 @@ struct RcFile
     // Global data
     QList<Data::Include> includes;
     QHash<int, QString> resourceMap;
+    // Hash of the existing included files, to know if they have changed since the file was parsed
+    QHash<QString, QByteArray> includeHashes;
 
     // Data by languages
     QHash<QString, Data> data;
 
+    // Top-level blocks of the content, a block ends where the next one starts
+    // Used to parse again only the blocks changed by an edit
+    struct Block
+    {
+        enum Kind {
+            Resource,
+            Directive,
+            Include,
+            Language,
+        };
+        Kind kind = Resource;
+        int from = 0;
+        int line = 1;
+        QString language;
+    };
+    QList<Block> blocks;
+
+    // Language each merged language has been merged into, see mergeLanguages
+    QHash<QString, QString> mergedLanguages;
+
     void mergeLanguages(const QStringList &languages, const QString &newLanguage);
 };
 
-// Parse method
-RcFile parse(const QString &fileName);
+// Parse methods
+enum class ParseMode {
+    Auto, // Language sections are parsed in parallel when possible
+    Sequential,
+};
+RcFile parse(const QString &fileName, ParseMode mode = ParseMode::Auto);
+RcFile parse(const QString &fileName, const QString &cacheDir);
+bool reparse(RcFile &rcFile, const QString &content);
 
 // Conversion methods
 QList<Asset> convertAssets(const Data &data, Asset::ConversionFlags flags = Asset::AllFlags);
@@ -46,12 +74,18 @@ Widget convertDialog(const Data &data, const Data::Dialog &dialog,
 QList<Action> convertActions(const Data &data, Asset::ConversionFlags flags = Asset::AllFlags);
 
 // Write methods
-void writeAssetsToImage(const QList<Asset> &assets, Asset::TransparentColors colors = Asset::AllColors);
+bool writeAssetsToImage(const QList<Asset> &assets, Asset::TransparentColors colors = Asset::AllColors);
+bool writeAssetsToAtlas(const QList<Asset> &assets, const QString &fileName,
+                        Asset::TransparentColors colors = Asset::AllColors);
 
 void writeAssetsToQrc(const QList<Asset> &assets, QIODevice *device, const QString &fileName);
 
 void writeDialogToUi(const Widget &widget, QIODevice *device);
 
+bool writeDialogsToUi(const Data &data, const QStringList &dialogIds, const QString &path,
+                      Widget::ConversionFlags flags = Widget::UpdateGeometry, double scaleX = 1.5,
+                      double scaleY = 1.65);
+
 QString convertLanguageToCode(const QString &name);
 
 } // namespace RcCore
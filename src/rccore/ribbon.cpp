@@ -10,7 +10,6 @@
 
 #include "ribbon.h"
 #include "utils/log.h"
-#include <kdalgorithms.h>
 
 #include <pugixml.hpp>
 
@@ -194,7 +193,7 @@ static RibbonElement readElement(pugi::xml_node node)
 
     RibbonElement element;
     element.type = node.child("ELEMENT_NAME").text().as_string();
-    element.id = node.select_node("ID/NAME").node().text().as_string();
+    element.id = node.child("ID").child("NAME").text().as_string();
     element.text = node.child("TEXT").text().as_string();
     element.keys = node.child("KEYS").text().as_string();
     element.smallIndex = node.child("INDEX_SMALL").text().as_int(-1);
@@ -253,15 +252,31 @@ bool Ribbon::load()
         return false;
     }
 
-    auto menuNode = document.select_nodes("/AFX_RIBBON/RIBBON_BAR/CATEGORY_MAIN").first().node();
+    const auto ribbonBarNode = document.child("AFX_RIBBON").child("RIBBON_BAR");
+
+    auto menuNode = ribbonBarNode.child("CATEGORY_MAIN");
     menu = readMenu(menuNode);
 
-    auto categoriesNode = document.select_nodes("/AFX_RIBBON/RIBBON_BAR/CATEGORIES").first().node();
+    auto categoriesNode = ribbonBarNode.child("CATEGORIES");
     categories = readItems<RibbonCategory>(categoriesNode, readCategory);
 
-    auto contextsNode = document.select_nodes("/AFX_RIBBON/RIBBON_BAR/CONTEXTS").first().node();
+    auto contextsNode = ribbonBarNode.child("CONTEXTS");
     contexts = readItems<RibbonContext>(contextsNode, readContext);
 
+    // The first element with a given id wins, the menu first and then the categories
+    elementIndex.clear();
+    auto indexElements = [this](const QList<RibbonElement> &elements, int category, int panel) {
+        for (int i = 0; i < elements.size(); ++i) {
+            if (!elementIndex.contains(elements.at(i).id))
+                elementIndex.insert(elements.at(i).id, {category, panel, i});
+        }
+    };
+    indexElements(menu.elements, -1, -1);
+    for (int category = 0; category < categories.size(); ++category) {
+        const auto &panels = categories.at(category).panels;
+        for (int panel = 0; panel < panels.size(); ++panel)
+            indexElements(panels.at(panel).elements, category, panel);
+    }
     return true;
 }
 
@@ -271,26 +286,12 @@ bool Ribbon::load()
  */
 RibbonElement Ribbon::elementFromId(const QString &id) const
 {
-    const auto menuElements = menu.elements;
-    auto result = kdalgorithms::find_if(menuElements, [&id](const auto &item) {
-        return item.id == id;
-    });
-    if (result) {
-        return *result;
-    }
-
-    const auto categoriesElements = categories;
-    for (const auto &cat : categoriesElements) {
-        for (const auto &panel : cat.panels) {
-            auto result = kdalgorithms::find_if(panel.elements, [&id](const auto &item) {
-                return item.id == id;
-            });
-            if (result) {
-                return *result;
-            }
-        }
-    }
-    return {};
+    const auto it = elementIndex.constFind(id);
+    if (it == elementIndex.cend())
+        return {};
+    if (it->category == -1)
+        return menu.elements.at(it->element);
+    return categories.at(it->category).panels.at(it->panel).elements.at(it->element);
 }
 
 bool operator==(const RibbonElement &lhs, const RibbonElement &rhs)
@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include <QHash>
 #include <QList>
 #include <QVariant>
 
@@ -123,6 +124,15 @@ public:
     // Internal data
     int line = -1;
     QString fileName;
+    // Position of an element in the menu (category is -1) or in a category panel
+    struct ElementPosition
+    {
+        int category = -1;
+        int panel = -1;
+        int element = -1;
+    };
+    // Map an element id to its position in the menu or the categories, built when loading
+    QHash<QString, ElementPosition> elementIndex;
 
     bool load();
     Q_INVOKABLE RcCore::RibbonElement elementFromId(const QString &id) const;
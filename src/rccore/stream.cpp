@@ -10,24 +10,38 @@
 
 #include "stream.h"
 
-#include <QTextStream>
+#include <QIODevice>
+#include <QStringDecoder>
 
 namespace RcCore {
 
 Stream::Stream(QIODevice *device)
 {
-    QTextStream stream(device);
-    m_content = stream.readAll();
+    // Decode the whole file once, the lexer then works on views of the decoded content
+    const QByteArray data = device->readAll();
+    QStringDecoder decoder(QStringConverter::encodingForData(data).value_or(QStringConverter::Utf8));
+    m_content = decoder(data);
+    m_end = static_cast<int>(m_content.size());
 }
 
 Stream::Stream(const QString &text)
+    : m_content(text)
+    , m_end(static_cast<int>(text.size()))
 {
-    m_content = text;
+}
+
+Stream::Stream(const QString &text, int from, int to, int line)
+    : m_content(text)
+    , m_pos(from)
+    , m_end(to)
+    , m_line(line)
+{
+    Q_ASSERT(from >= 0 && from <= to && to <= text.size());
 }
 
 bool Stream::atEnd() const
 {
-    return m_pos == m_content.size();
+    return m_pos >= m_end;
 }
 
 int Stream::line() const
@@ -52,7 +66,7 @@ QChar Stream::peek() const
     return m_content.at(m_pos);
 }
 
-QString Stream::content() const
+const QString &Stream::content() const
 {
     return m_content;
 }
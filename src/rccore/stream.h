@@ -12,6 +12,7 @@
 
 #include <QChar>
 #include <QString>
+#include <QStringView>
 
 class QIODevice;
 
@@ -22,6 +23,8 @@ class Stream
 public:
     explicit Stream(QIODevice *device);
     Stream(const QString &text);
+    // Stream only the part of `text` between `from` and `to`, `line` being the line number at `from`
+    Stream(const QString &text, int from, int to, int line);
 
     bool atEnd() const;
     int line() const;
@@ -29,11 +32,16 @@ public:
     QChar next();
     QChar peek() const;
 
-    QString content() const;
+    int position() const { return m_pos; }
+    // Returns a view on the content, from position `from` to the current position
+    QStringView slice(int from) const { return QStringView(m_content).mid(from, m_pos - from); }
+
+    const QString &content() const;
 
 private:
     QString m_content;
     int m_pos = 0;
+    int m_end = 0;
     int m_line = 1;
 };
 
@@ -13,6 +13,7 @@
 #include "predicates.h"
 
 #include <QStringList>
+#include <algorithm>
 #include <kdalgorithms.h>
 #include <tree_sitter/api.h>
 
@@ -220,6 +221,10 @@ QueryCursor::~QueryCursor()
 
 QueryCursor::QueryCursor(QueryCursor &&other) noexcept
     : m_query(std::move(other.m_query))
+    , m_progressCallback(std::move(other.m_progressCallback))
+    , m_startByte(other.m_startByte)
+    , m_endByte(other.m_endByte)
+    , m_cancelled(other.m_cancelled)
     , m_predicates(std::move(other.m_predicates))
     , m_cursor(std::move(other.m_cursor))
 {
@@ -234,6 +239,12 @@ QueryCursor &QueryCursor::operator=(QueryCursor &&other) noexcept
 
 void QueryCursor::swap(QueryCursor &other) noexcept
 {
+    std::swap(m_query, other.m_query);
+    std::swap(m_progressCallback, other.m_progressCallback);
+    std::swap(m_startByte, other.m_startByte);
+    std::swap(m_endByte, other.m_endByte);
+    std::swap(m_cancelled, other.m_cancelled);
+    std::swap(m_predicates, other.m_predicates);
     std::swap(m_cursor, other.m_cursor);
 }
 
@@ -244,10 +255,12 @@ void QueryCursor::execute(std::shared_ptr<Query> query, const Node &node, std::u
         m_predicates->setRootNode(node);
     }
     m_query = std::move(query);
+    m_startByte = ts_node_start_byte(node.m_node);
+    m_endByte = ts_node_end_byte(node.m_node);
     ts_query_cursor_exec(m_cursor, m_query->m_query, node.m_node);
 }
 
-void QueryCursor::setProgressCallback(std::function<void()> callback)
+void QueryCursor::setProgressCallback(ProgressCallback callback)
 {
     m_progressCallback = std::move(callback);
 }
@@ -256,7 +269,20 @@ std::optional<QueryMatch> QueryCursor::nextMatch()
 {
     TSQueryMatch match;
 
+    if (m_cancelled) {
+        return {};
+    }
+
     while (ts_query_cursor_next_match(m_cursor, &match)) {
+        if (m_progressCallback) {
+            const uint32_t position =
+                match.capture_count > 0 ? ts_node_start_byte(match.captures[0].node) : m_startByte;
+            if (!m_progressCallback(position - std::min(position, m_startByte), m_endByte - m_startByte)) {
+                m_cancelled = true;
+                return {};
+            }
+        }
+
         QueryMatch result(match, m_query);
         if (m_predicates) {
             m_predicates->executeCommands(result);
@@ -266,10 +292,6 @@ std::optional<QueryMatch> QueryCursor::nextMatch()
         } else {
             return result;
         }
-
-        if (m_progressCallback) {
-            m_progressCallback();
-        }
     }
     return {};
 }
@@ -148,13 +148,19 @@ public:
 
     // The progress callback is called after each match is found, even if it is discarded later by the predicate engine.
     // It allows the UI to update and remain responsive while the query is running.
-    void setProgressCallback(std::function<void()> callback);
+    // It receives the position of the match and the size of the queried node (in bytes), and returns false to cancel
+    // the query: no more matches are returned then.
+    using ProgressCallback = std::function<bool(uint32_t position, uint32_t size)>;
+    void setProgressCallback(ProgressCallback callback);
 
 private:
     // The query must be kept alive for as long as the cursor is alive.
     // Otherwise, no new matches can be returned and the Predicates can't be executed.
     std::shared_ptr<Query> m_query;
-    std::function<void()> m_progressCallback;
+    ProgressCallback m_progressCallback;
+    uint32_t m_startByte = 0;
+    uint32_t m_endByte = 0;
+    bool m_cancelled = false;
 
     std::unique_ptr<Predicates> m_predicates;
     TSQueryCursor *m_cursor;
@@ -49,4 +49,9 @@ Node Tree::rootNode() const
     return Node(ts_tree_root_node(m_tree));
 }
 
+Tree Tree::copy() const
+{
+    return Tree(ts_tree_copy(m_tree));
+}
+
 }
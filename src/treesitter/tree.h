@@ -31,6 +31,9 @@ public:
 
     Node rootNode() const;
 
+    // Trees are not thread-safe, a (cheap) copy is needed to use the same tree in another thread.
+    Tree copy() const;
+
     void swap(Tree &other) noexcept;
 
 private:
@@ -34,6 +34,37 @@ Script {
         compare(rcdoc.type, Document.Rc)
     }
 
+    function test_queryIter() {
+        Project.root = Dir.currentScriptPath + "/projects/mfc-dialog"
+
+        var cppdoc = Project.open("TutorialDlg.cpp")
+        var query = "(function_definition) @function"
+        var count = 0
+        for (const match of cppdoc.queryIter(query))
+            count++
+        compare(count, cppdoc.query(query).length)
+
+        var matches = cppdoc.queryIter(query)
+        for (const match of matches) {
+            verify(match.get("function").text.length > 0)
+            break
+        }
+        verify(matches.isDone)
+    }
+
+    function test_queryIterInScripts() {
+        Project.root = Dir.currentScriptPath + "/projects/mfc-dialog"
+
+        // The document is already used by this engine, each script runs in its own engine
+        var cppdoc = Project.open("TutorialDlg.cpp")
+        var count = cppdoc.query("(function_definition) @function").length
+
+        Utils.runScript(Dir.currentScriptPath + "/tst_project/queryiter_count.js")
+        compare(Utils.getGlobal("queryIterCount"), String(count))
+        Utils.runScript(Dir.currentScriptPath + "/tst_project/queryiter_break.js")
+        compare(Utils.getGlobal("queryIterDone"), "true")
+    }
+
     function test_findInFiles() {
         if(Project.isFindInFilesAvailable()) {
         let simplePattern = "CTutorialApp::InitInstance()"
@@ -0,0 +1,8 @@
+// Run by tst_project.qml, in another engine than the test
+function main() {
+    var cppdoc = Project.open("TutorialDlg.cpp")
+    var matches = cppdoc.queryIter("(function_definition) @function")
+    for (const match of matches)
+        break
+    Utils.setGlobal("queryIterDone", matches.isDone)
+}
@@ -0,0 +1,8 @@
+// Run by tst_project.qml, in another engine than the test
+function main() {
+    var cppdoc = Project.open("TutorialDlg.cpp")
+    var count = 0
+    for (const match of cppdoc.queryIter("(function_definition) @function"))
+        count++
+    Utils.setGlobal("queryIterCount", count)
+}
@@ -14,6 +14,7 @@
 #include "core/lsp_utils.h"
 #include "core/project.h"
 #include "core/querymatch.h"
+#include "core/querymatchiterator.h"
 
 #include <QAction>
 #include <QPlainTextEdit>
@@ -21,6 +22,7 @@
 #include <QTemporaryFile>
 #include <QTest>
 #include <kdalgorithms.h>
+#include <memory>
 
 #define INIT_KNUT_PROJECT                                                                                              \
     Core::KnutCore core;                                                                                               \
@@ -376,6 +378,14 @@ private slots:
         QCOMPARE(match.getAll("return").at(0).text(), "int");
         QCOMPARE(match.getAll("param").at(0).text(), "int argc");
         QCOMPARE(match.getAll("param").at(1).text(), "char *argv[]");
+
+        // Captures not accessed yet should still follow the changes in the document
+        const auto otherMatch = codedocument->query("(function_definition declarator: (_) @declarator)").first();
+        codedocument->gotoStartOfDocument();
+        codedocument->insert("// Comment\n");
+        QCOMPARE(match.get("name").text(), "main");
+        QCOMPARE(match.getAll("param").at(1).text(), "char *argv[]");
+        QCOMPARE(otherMatch.get("declarator").text(), "main(int argc, char *argv[])");
     }
 
     void failedQuery()
@@ -421,6 +431,48 @@ private slots:
         QCOMPARE(matches.size(), 2);
     }
 
+    void queryIter()
+    {
+        INIT_KNUT_PROJECT;
+
+        auto codedocument = qobject_cast<Core::CodeDocument *>(Core::Project::instance()->get("main.cpp"));
+        const QString query = "(function_definition declarator: (_) @declarator)";
+        const auto matches = codedocument->query(query);
+
+        // Same matches as query
+        {
+            std::unique_ptr<Core::QueryMatchIterator> iterator(codedocument->createQueryIterator(query));
+            qsizetype count = 0;
+            while (auto match = iterator->nextMatch()) {
+                QCOMPARE(match->get("declarator").text(), matches.at(count).get("declarator").text());
+                ++count;
+            }
+            QCOMPARE(count, matches.size());
+            QVERIFY(iterator->isDone());
+        }
+
+        // Early termination
+        {
+            std::unique_ptr<Core::QueryMatchIterator> iterator(codedocument->createQueryIterator(query));
+            QVERIFY(iterator->nextMatch().has_value());
+            iterator->close();
+            QVERIFY(iterator->isDone());
+            QVERIFY(!iterator->nextMatch().has_value());
+        }
+
+        // Iteration stops when the document is changed, but the matches stay valid
+        {
+            std::unique_ptr<Core::QueryMatchIterator> iterator(codedocument->createQueryIterator(query));
+            const auto match = iterator->nextMatch();
+            QVERIFY(match.has_value());
+            codedocument->gotoStartOfDocument();
+            codedocument->insert("// Comment\n");
+            QVERIFY(!iterator->nextMatch().has_value());
+            QVERIFY(iterator->isDone());
+            QCOMPARE(match->get("declarator").text(), "main(int argc, char *argv[])");
+        }
+    }
+
     void ast()
     {
         Test::FileTester header(Test::testDataPath() + "/tst_codedocument/ast/header.h");
@@ -0,0 +1,105 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "common/test_utils.h"
+#include "core/knutcore.h"
+#include "core/logger.h"
+#include "core/rangemark.h"
+#include "core/settings.h"
+#include "core/textdocument.h"
+
+#include <QTest>
+
+class TestLogger : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QString params(const Core::HistoryModel &model, int row)
+    {
+        return model.index(row, Core::HistoryModel::ParamCol).data().toString();
+    }
+
+private slots:
+    void initTestCase() { Q_INIT_RESOURCE(core); }
+
+    void history()
+    {
+        Core::KnutCore core;
+        Core::TextDocument document;
+        // Nothing is recorded without a history model
+        document.setText("Hello\nWorld");
+
+        Core::HistoryModel model;
+        document.setText("Hello\nWorld");
+        document.positionAt(2, 1);
+        document.undo(1);
+        document.undo(2);
+        document.text();
+        QCOMPARE(model.rowCount(), 4);
+
+        QCOMPARE(model.index(0, Core::HistoryModel::NameCol).data().toString(), "TextDocument::setText");
+        QCOMPARE(params(model, 0), R"(text: "Hello\\nWorld")");
+        QCOMPARE(params(model, 1), "line: 2, column: 1");
+        // Merged with the previous call
+        QCOMPARE(params(model, 2), "3");
+        QCOMPARE(params(model, 3), " => text");
+    }
+
+    void mutableParameters()
+    {
+        Core::KnutCore core;
+        Core::TextDocument document;
+        document.setText("Hello World");
+
+        Core::HistoryModel model;
+        const auto range = document.createRangeMark(0, 5);
+        // Calls replace(int, int, QString) internally, which is not recorded
+        document.replace(range, "Bye");
+        QCOMPARE(model.rowCount(), 2);
+
+        // The range mark has been updated by the replace, but the history keeps the value at the time of the call
+        QCOMPARE(range.toString(), "[0, 3]");
+        QCOMPARE(params(model, 1), R"([0, 5], "Bye")");
+
+        const QString script = model.createScript(0, 1);
+        QVERIFY(script.contains("document.createRangeMark(0, 5)"));
+        QVERIFY(script.contains(R"(document.replace([0, 5], "Bye"))"));
+    }
+
+    void limit()
+    {
+        Core::KnutCore core;
+        Core::TextDocument document;
+        document.setText("Hello World");
+
+        Core::HistoryModel model;
+        // The limit comes from the settings
+        QCOMPARE(model.limit(), DEFAULT_VALUE(int, HistoryLimit));
+        model.setLimit(3);
+
+        document.gotoStartOfDocument();
+        document.undo(1);
+        document.undo(1);
+        document.gotoEndOfDocument();
+        document.positionAt(1, 1);
+        QCOMPARE(model.rowCount(), 3);
+        QCOMPARE(model.index(0, Core::HistoryModel::NameCol).data().toString(), "TextDocument::undo");
+        QCOMPARE(params(model, 0), "2");
+        QCOMPARE(model.index(2, Core::HistoryModel::NameCol).data().toString(), "TextDocument::positionAt");
+
+        model.setLimit(1);
+        QCOMPARE(model.rowCount(), 1);
+        QCOMPARE(params(model, 0), "line: 1, column: 1");
+    }
+};
+
+QTEST_MAIN(TestLogger)
+#include "tst_logger.moc"
@@ -0,0 +1,93 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "common/test_utils.h"
+#include "core/knutcore.h"
+#include "core/profiler.h"
+#include "core/rangemark.h"
+#include "core/textdocument.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTest>
+#include <algorithm>
+
+class TestProfiler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() { Q_INIT_RESOURCE(core); }
+
+    void cleanup()
+    {
+        Core::Profiler::setEnabled(false);
+        Core::Profiler::clear();
+    }
+
+    void disabled()
+    {
+        Core::KnutCore core;
+        Core::TextDocument document;
+        document.setText("Hello World");
+        QVERIFY(Core::Profiler::stats().isEmpty());
+    }
+
+    void apiCalls()
+    {
+        Core::KnutCore core;
+        Core::TextDocument document;
+        document.setText("Hello World");
+
+        Core::Profiler::setEnabled(true);
+        document.gotoEndOfDocument();
+        // Calls replace(int, int, QString) internally, which is also profiled
+        document.replace(document.createRangeMark(0, 5), "Bye");
+        Core::Profiler::setEnabled(false);
+        QCOMPARE(document.text(), "Bye World");
+
+        const auto stats = Core::Profiler::stats();
+        auto find = [&stats](const QString &name) {
+            auto it = std::ranges::find(stats, name, &Core::Profiler::Stats::name);
+            return it == stats.cend() ? Core::Profiler::Stats {} : *it;
+        };
+        QCOMPARE(find("TextDocument::gotoEndOfDocument").count, 1);
+        QCOMPARE(find("TextDocument::createRangeMark").count, 1);
+        const auto replace = find("TextDocument::replace");
+        QCOMPARE(replace.count, 2);
+        QVERIFY(replace.self <= replace.total);
+        QCOMPARE(replace.categories[Core::Profiler::TreeSitter], 0);
+        QVERIFY(replace.categories[Core::Profiler::TextEditing] > 0);
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString fileName = dir.filePath("profile.json");
+        QVERIFY(Core::Profiler::writeTrace(fileName));
+
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QJsonParseError error;
+        const auto json = QJsonDocument::fromJson(file.readAll(), &error).object();
+        QCOMPARE(error.error, QJsonParseError::NoError);
+        const auto events = json.value("traceEvents").toArray();
+        QCOMPARE(events.size(), 4);
+        for (const auto &event : events) {
+            QCOMPARE(event.toObject().value("ph").toString(), "X");
+            QCOMPARE(event.toObject().value("cat").toString(), "api");
+        }
+        QCOMPARE(json.value("summary").toArray().size(), 3);
+    }
+};
+
+QTEST_MAIN(TestProfiler)
+#include "tst_profiler.moc"
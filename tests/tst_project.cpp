@@ -0,0 +1,180 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "core/documentsnapshot.h"
+#include "core/knutcore.h"
+#include "core/project.h"
+#include "core/textdocument.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QtConcurrent>
+
+static void writeFile(const QString &fileName, const QByteArray &data)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(data);
+}
+
+static QByteArray readFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return file.readAll();
+}
+
+class TestProject : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() { Q_INIT_RESOURCE(core); }
+
+    void replaceInFiles()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString root = dir.path();
+        writeFile(root + "/lf.cpp", "CFoo foo;\nCFooBar bar;\ncfoo baz;\n");
+        writeFile(root + "/crlf_bom.h", "\xef\xbb\xbf"
+                                        "class CFoo;\r\nCFoo *foo;\r\n");
+        writeFile(root + "/opened.cpp", "CFoo opened;\n");
+        writeFile(root + "/skipped.txt", "CFoo skipped;\n");
+        QVERIFY(QDir(root).mkpath(".git"));
+        writeFile(root + "/.git/git.cpp", "CFoo git;\n");
+        QVERIFY(QDir(root).mkpath("build"));
+        writeFile(root + "/build/CMakeCache.txt", "");
+        writeFile(root + "/build/moc_foo.cpp", "CFoo build;\n");
+
+        Core::KnutCore core;
+        auto project = Core::Project::instance();
+        project->setRoot(root);
+
+        auto document = qobject_cast<Core::TextDocument *>(project->get("opened.cpp"));
+        QVERIFY(document);
+
+        const auto results = project->replaceInFiles("CFoo", "Foo",
+                                                     Core::TextDocument::FindCaseSensitively
+                                                         | Core::TextDocument::FindWholeWords,
+                                                     {"*.cpp", "*.h"});
+        QCOMPARE(results.size(), 3);
+
+        QHash<QString, int> counts;
+        for (const auto &result : results) {
+            const auto map = result.toMap();
+            QVERIFY(!map.contains("error"));
+            counts[QFileInfo(map.value("file").toString()).fileName()] = map.value("count").toInt();
+        }
+        QCOMPARE(counts.value("lf.cpp"), 1);
+        QCOMPARE(counts.value("crlf_bom.h"), 2);
+        QCOMPARE(counts.value("opened.cpp"), 1);
+
+        QCOMPARE(readFile(root + "/lf.cpp"), "Foo foo;\nCFooBar bar;\ncfoo baz;\n");
+        QCOMPARE(readFile(root + "/crlf_bom.h"), "\xef\xbb\xbf"
+                                                 "class Foo;\r\nFoo *foo;\r\n");
+        QCOMPARE(readFile(root + "/skipped.txt"), "CFoo skipped;\n");
+        QCOMPARE(readFile(root + "/.git/git.cpp"), "CFoo git;\n");
+        QCOMPARE(readFile(root + "/build/moc_foo.cpp"), "CFoo build;\n");
+
+        // Opened documents are changed in memory, but not saved
+        QCOMPARE(document->text(), "Foo opened;\n");
+        QVERIFY(document->hasChanged());
+        QCOMPARE(readFile(root + "/opened.cpp"), "CFoo opened;\n");
+
+        // Whole words apply to all alternatives of a regexp
+        writeFile(root + "/regexp.cpp", "foobar barfoo foo\n");
+        const auto regexpResults = project->replaceInFiles("foo|bar", "baz",
+                                                           Core::TextDocument::FindRegexp
+                                                               | Core::TextDocument::FindWholeWords,
+                                                           {"regexp.cpp"});
+        QCOMPARE(regexpResults.size(), 1);
+        QCOMPARE(regexpResults.first().toMap().value("count").toInt(), 1);
+        QCOMPARE(readFile(root + "/regexp.cpp"), "foobar barfoo baz\n");
+    }
+
+    void snapshot()
+    {
+        const auto snapshot = Core::DocumentSnapshot::fromText(
+            "test.cpp", "class A {\n    void foo();\n    int m_bar;\n};\n", Core::Document::Type::Cpp);
+        QVERIFY(snapshot.isValid());
+
+        const auto &symbols = snapshot.symbols();
+        QCOMPARE(symbols.size(), 3);
+        QCOMPARE(symbols.at(0).name, "A");
+        QCOMPARE(symbols.at(0).kind, Core::Symbol::Class);
+        QCOMPARE(symbols.at(1).name, "A::foo");
+        QCOMPARE(symbols.at(1).kind, Core::Symbol::Method);
+        QCOMPARE(symbols.at(2).name, "A::m_bar");
+        QCOMPARE(symbols.at(2).kind, Core::Symbol::Field);
+
+        // The same snapshot can be queried from multiple threads
+        const QList<int> runs(16, 0);
+        const auto names = QtConcurrent::blockingMapped(runs, [&snapshot](int) {
+            const auto matches = snapshot.queryMatches("(field_identifier) @name");
+            QStringList result;
+            for (const auto &match : matches)
+                result.push_back(snapshot.textAt(match.first().start, match.first().end));
+            return result;
+        });
+        for (const auto &result : names)
+            QCOMPARE(result, QStringList({"foo", "m_bar"}));
+    }
+
+    void analyzeFiles()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString root = dir.path();
+        writeFile(root + "/a.cpp", "class A {};\nint main() { return 0; }\n");
+        writeFile(root + "/b.h", "class B : public A {};\r\nclass C {};\r\n");
+        writeFile(root + "/none.cpp", "int foo();\n");
+        writeFile(root + "/opened.cpp", "class Saved {};\n");
+
+        Core::KnutCore core;
+        auto project = Core::Project::instance();
+        project->setRoot(root);
+
+        auto document = qobject_cast<Core::TextDocument *>(project->get("opened.cpp"));
+        QVERIFY(document);
+        document->setText("class Opened {};\n");
+
+        const auto results = project->analyzeFiles({"a.cpp", "b.h", "none.cpp", "opened.cpp", "missing.cpp"},
+                                                   QJSValue("(class_specifier name: (_) @name)"));
+        QCOMPARE(results.size(), 4);
+
+        QHash<QString, QStringList> classes;
+        for (const auto &result : results) {
+            const auto map = result.toMap();
+            const QString fileName = QFileInfo(map.value("file").toString()).fileName();
+            if (map.contains("error")) {
+                QCOMPARE(fileName, "missing.cpp");
+                continue;
+            }
+            for (const auto &match : map.value("matches").toList()) {
+                const auto captures = match.toMap().value("captures").toList();
+                QCOMPARE(captures.size(), 1);
+                classes[fileName].push_back(captures.first().toMap().value("text").toString());
+            }
+        }
+        QCOMPARE(classes.value("a.cpp"), QStringList({"A"}));
+        QCOMPARE(classes.value("b.h"), QStringList({"B", "C"}));
+        QCOMPARE(classes.value("opened.cpp"), QStringList({"Opened"}));
+        QVERIFY(!classes.contains("none.cpp"));
+    }
+};
+
+QTEST_MAIN(TestProject)
+#include "tst_project.moc"
@@ -89,6 +89,25 @@ private slots:
         QCOMPARE(lexer.next()->toString(), token);
     }
 
+    void testKeywords()
+    {
+        const auto keywords = Lexer::keywords();
+        QVERIFY(!keywords.isEmpty());
+        for (const auto &keyword : keywords) {
+            Stream stream(keyword);
+            Lexer lexer(stream);
+            QCOMPARE(lexer.next()->type, Token::Keyword);
+        }
+
+        Stream stream("BEGIN BEGINS begin BEGI MFT_STRING");
+        Lexer lexer(stream);
+        QCOMPARE(lexer.next()->toKeyword(), Keywords::BEGIN);
+        QCOMPARE(lexer.next()->type, Token::Word);
+        QCOMPARE(lexer.next()->type, Token::Word);
+        QCOMPARE(lexer.next()->type, Token::Word);
+        QCOMPARE(lexer.next()->toKeyword(), Keywords::MFTSTRING);
+    }
+
     void testControl()
     {
         Stream stream("    COMBOBOX         \"Text\",CLASS, -1, 05, 1, 234,STYLE_1 |"
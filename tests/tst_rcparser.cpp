@@ -11,6 +11,10 @@
 #include "common/test_utils.h"
 #include "rccore/rcfile.h"
 
+#include <QDir>
+#include <QFile>
+#include <QStringEncoder>
+#include <QTemporaryDir>
 #include <QTest>
 
 using namespace RcCore;
@@ -142,6 +146,234 @@ private slots:
         QCOMPARE(rcFile.isValid, true);
     }
 
+    void testIndexes()
+    {
+        RcFile rcFile = parse(Test::testDataPath() + "/rcfiles/dialog/dialog.rc");
+        const auto usData = rcFile.data.value(en_US);
+        QCOMPARE(usData.dialogIndex.count, usData.dialogs.size());
+        for (const auto &dialog : usData.dialogs)
+            QCOMPARE(usData.dialog(dialog.id), &dialog);
+        QCOMPARE(usData.dialog("IDD_DOES_NOT_EXIST"), nullptr);
+
+        // Indexes are updated when merging languages
+        const auto usDialogCount = usData.dialogs.size();
+        const auto frDialogCount = rcFile.data.value(fr_FR).dialogs.size();
+        rcFile.mergeLanguages({en_US, fr_FR}, "[default]");
+        const auto data = rcFile.data.value("[default]");
+        QCOMPARE(data.dialogs.size(), usDialogCount + frDialogCount);
+        QCOMPARE(data.dialogIndex.count, data.dialogs.size());
+        QVERIFY(data.dialog(usData.dialogs.first().id));
+        QCOMPARE(data.dialog(usData.dialogs.first().id)->id, usData.dialogs.first().id);
+
+        // Outdated indexes are not used
+        auto newData = data;
+        newData.dialogs.push_back({.id = "IDD_NEW_DIALOG"});
+        QVERIFY(newData.dialog("IDD_NEW_DIALOG"));
+
+        // Indexes are verified if the list is changed without changing its size, and rebuilt by updateIndexes
+        auto swappedData = usData;
+        std::swap(swappedData.dialogs.first(), swappedData.dialogs.last());
+        const auto lastId = swappedData.dialogs.first().id;
+        QVERIFY(swappedData.dialog(lastId));
+        QCOMPARE(swappedData.dialog(lastId)->id, lastId);
+        QCOMPARE(swappedData.dialogIndex.indexes.value(lastId), swappedData.dialogs.size() - 1);
+        swappedData.updateIndexes();
+        QCOMPARE(swappedData.dialogIndex.indexes.value(lastId), 0);
+        QCOMPARE(swappedData.dialog(lastId), &swappedData.dialogs.first());
+    }
+
+    void testParseConcurrently()
+    {
+        // The file has multiple languages, so the language sections are parsed in parallel
+        const QString fileName = Test::testDataPath() + "/rcfiles/dialog/dialog.rc";
+        const RcFile rcFile = parse(fileName);
+        const RcFile sequentialFile = parse(fileName, ParseMode::Sequential);
+        QCOMPARE(rcFile.isValid, true);
+        QCOMPARE(sequentialFile.isValid, true);
+        QVERIFY(rcFile.data.size() > 1);
+
+        QCOMPARE(rcFile.includes.size(), sequentialFile.includes.size());
+        for (int i = 0; i < rcFile.includes.size(); ++i)
+            QCOMPARE(rcFile.includes.at(i).fileName, sequentialFile.includes.at(i).fileName);
+        QCOMPARE(rcFile.resourceMap, sequentialFile.resourceMap);
+        QCOMPARE(rcFile.blocks.size(), sequentialFile.blocks.size());
+        for (int i = 0; i < rcFile.blocks.size(); ++i) {
+            QCOMPARE(rcFile.blocks.at(i).kind, sequentialFile.blocks.at(i).kind);
+            QCOMPARE(rcFile.blocks.at(i).from, sequentialFile.blocks.at(i).from);
+            QCOMPARE(rcFile.blocks.at(i).line, sequentialFile.blocks.at(i).line);
+            QCOMPARE(rcFile.blocks.at(i).language, sequentialFile.blocks.at(i).language);
+        }
+
+        auto compareIds = [](const auto &list, const auto &expectedList) {
+            QCOMPARE(list.size(), expectedList.size());
+            for (int i = 0; i < list.size(); ++i) {
+                QCOMPARE(list.at(i).id, expectedList.at(i).id);
+                QCOMPARE(list.at(i).line, expectedList.at(i).line);
+            }
+        };
+
+        auto languages = rcFile.data.keys();
+        auto expectedLanguages = sequentialFile.data.keys();
+        languages.sort();
+        expectedLanguages.sort();
+        QCOMPARE(languages, expectedLanguages);
+        for (const auto &language : std::as_const(languages)) {
+            const auto data = rcFile.data.value(language);
+            const auto expectedData = sequentialFile.data.value(language);
+            QCOMPARE(data.strings, expectedData.strings);
+            compareIds(data.icons, expectedData.icons);
+            compareIds(data.assets, expectedData.assets);
+            compareIds(data.acceleratorTables, expectedData.acceleratorTables);
+            compareIds(data.menus, expectedData.menus);
+            compareIds(data.toolBars, expectedData.toolBars);
+            compareIds(data.dialogDataList, expectedData.dialogDataList);
+            compareIds(data.dialogs, expectedData.dialogs);
+            for (int i = 0; i < data.dialogs.size(); ++i) {
+                compareIds(data.dialogs.at(i).controls, expectedData.dialogs.at(i).controls);
+                for (int j = 0; j < data.dialogs.at(i).controls.size(); ++j) {
+                    QCOMPARE(data.dialogs.at(i).controls.at(j).styles,
+                             expectedData.dialogs.at(i).controls.at(j).styles);
+                }
+            }
+        }
+    }
+
+    void testSnapshot()
+    {
+        QTemporaryDir cacheDir;
+        QVERIFY(cacheDir.isValid());
+
+        const QString fileName = Test::testDataPath() + "/rcfiles/dialog/dialog.rc";
+        const RcFile rcFile = parse(fileName);
+        const RcFile parsedFile = parse(fileName, cacheDir.path());
+        QCOMPARE(QDir(cacheDir.path()).entryList({"*.rcs"}).size(), 1);
+
+        // Second time, the snapshot is used
+        const RcFile snapshotFile = parse(fileName, cacheDir.path());
+        for (const auto &file : {parsedFile, snapshotFile}) {
+            QCOMPARE(file.isValid, true);
+            QCOMPARE(file.fileName, rcFile.fileName);
+            QCOMPARE(file.content, rcFile.content);
+            QCOMPARE(file.includes.size(), rcFile.includes.size());
+            QCOMPARE(file.resourceMap, rcFile.resourceMap);
+            QCOMPARE(file.data.keys(), rcFile.data.keys());
+
+            const auto data = file.data.value(en_US);
+            const auto expectedData = rcFile.data.value(en_US);
+            QCOMPARE(data.strings, expectedData.strings);
+            QCOMPARE(data.dialogs.size(), expectedData.dialogs.size());
+            QCOMPARE(data.dialogs.first().controls.size(), expectedData.dialogs.first().controls.size());
+            QCOMPARE(data.dialogs.first().controls.last().styles, expectedData.dialogs.first().controls.last().styles);
+            QCOMPARE(data.dialogDataList.first().values, expectedData.dialogDataList.first().values);
+            QCOMPARE(file.data.value(fr_FR).icons.value(0).fileName, rcFile.data.value(fr_FR).icons.value(0).fileName);
+        }
+
+        // Changing the RC file replaces its snapshot
+        QTemporaryDir sourceDir;
+        QVERIFY(sourceDir.isValid());
+        const QString copyName = sourceDir.path() + "/dialog.rc";
+        QVERIFY(QFile::copy(fileName, copyName));
+        QVERIFY(QFile::copy(Test::testDataPath() + "/rcfiles/dialog/resource.h", sourceDir.path() + "/resource.h"));
+        QVERIFY(parse(copyName, cacheDir.path()).isValid);
+        QCOMPARE(QDir(cacheDir.path()).entryList({"*.rcs"}).size(), 2);
+        {
+            QFile file(copyName);
+            QVERIFY(file.open(QIODevice::Append));
+            // The RC file is encoded in UTF-16
+            QStringEncoder encoder(QStringConverter::Utf16LE);
+            file.write(encoder(QStringLiteral("\r\n// Changed\r\n")));
+        }
+        const RcFile changedFile = parse(copyName, cacheDir.path());
+        QVERIFY(changedFile.isValid);
+        QVERIFY(changedFile.content.contains("// Changed"));
+        QCOMPARE(QDir(cacheDir.path()).entryList({"*.rcs"}).size(), 2);
+        QCOMPARE(parse(copyName, cacheDir.path()).content, changedFile.content);
+    }
+
+    void testReparse()
+    {
+        RcFile rcFile = parse(Test::testDataPath() + "/rcfiles/dialog/dialog.rc");
+        QVERIFY(!rcFile.blocks.isEmpty());
+
+        // Change the caption of a dialog, and add a line after it
+        QString content = rcFile.content;
+        content.replace("CAPTION \"About dialog\"", "CAPTION \"About Knut\"\r\n");
+        QVERIFY(reparse(rcFile, content));
+
+        // The result is the same as a full parse
+        RcFile expected;
+        expected.fileName = rcFile.fileName;
+        QVERIFY(!reparse(expected, content));
+        QVERIFY(expected.isValid);
+        QCOMPARE(rcFile.content, expected.content);
+        QCOMPARE(rcFile.data.keys(), expected.data.keys());
+        QCOMPARE(rcFile.blocks.size(), expected.blocks.size());
+        for (int i = 0; i < rcFile.blocks.size(); ++i) {
+            QCOMPARE(rcFile.blocks.at(i).from, expected.blocks.at(i).from);
+            QCOMPARE(rcFile.blocks.at(i).line, expected.blocks.at(i).line);
+        }
+        for (const auto &language : {en_US, fr_FR}) {
+            const auto data = rcFile.data.value(language);
+            const auto expectedData = expected.data.value(language);
+            QCOMPARE(data.strings, expectedData.strings);
+            QCOMPARE(data.dialogs.size(), expectedData.dialogs.size());
+            for (int i = 0; i < data.dialogs.size(); ++i) {
+                QCOMPARE(data.dialogs.at(i).id, expectedData.dialogs.at(i).id);
+                QCOMPARE(data.dialogs.at(i).caption, expectedData.dialogs.at(i).caption);
+                QCOMPARE(data.dialogs.at(i).line, expectedData.dialogs.at(i).line);
+                QCOMPARE(data.dialogs.at(i).controls.size(), expectedData.dialogs.at(i).controls.size());
+            }
+            QCOMPARE(data.dialogDataList.size(), expectedData.dialogDataList.size());
+            for (int i = 0; i < data.dialogDataList.size(); ++i)
+                QCOMPARE(data.dialogDataList.at(i).line, expectedData.dialogDataList.at(i).line);
+        }
+        QCOMPARE(rcFile.data.value(en_US).dialog("IDD_ABOUTBOX")->caption, QString("About Knut"));
+
+        // Adding a LANGUAGE statement needs a full parse
+        content.replace("STRINGTABLE", "LANGUAGE LANG_GERMAN, SUBLANG_GERMAN\r\nSTRINGTABLE");
+        QVERIFY(!reparse(rcFile, content));
+        QVERIFY(rcFile.isValid);
+    }
+
+    void testReparseMerged()
+    {
+        RcFile rcFile = parse(Test::testDataPath() + "/rcfiles/dialog/dialog.rc");
+        const auto dialogCount = rcFile.data.value(en_US).dialogs.size() + rcFile.data.value(fr_FR).dialogs.size();
+        rcFile.mergeLanguages({en_US, fr_FR}, "[default]");
+
+        // The changed blocks are spliced into the merged data
+        QString content = rcFile.content;
+        content.replace("CAPTION \"About dialog\"", "CAPTION \"About Knut\"\r\n");
+        QVERIFY(reparse(rcFile, content));
+        QVERIFY(!rcFile.data.contains(en_US));
+        const auto data = rcFile.data.value("[default]");
+        QCOMPARE(data.dialogs.size(), dialogCount);
+        QCOMPARE(data.dialog("IDD_ABOUTBOX")->caption, QString("About Knut"));
+    }
+
+    void testReparseInclude()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString dataPath = Test::testDataPath() + "/rcfiles/dialog/";
+        QVERIFY(QFile::copy(dataPath + "dialog.rc", dir.filePath("dialog.rc")));
+        QVERIFY(QFile::copy(dataPath + "resource.h", dir.filePath("resource.h")));
+
+        RcFile rcFile = parse(dir.filePath("dialog.rc"));
+        QVERIFY(rcFile.isValid);
+        QVERIFY(reparse(rcFile, rcFile.content));
+
+        // A change in resource.h needs a full parse, even if the RC file is unchanged
+        {
+            QFile file(dir.filePath("resource.h"));
+            QVERIFY(file.open(QIODevice::Append));
+            file.write("#define IDD_NEW_DIALOG 200\r\n");
+        }
+        QVERIFY(!reparse(rcFile, rcFile.content));
+        QVERIFY(rcFile.isValid);
+        QCOMPARE(rcFile.resourceMap.value(200), QString("IDD_NEW_DIALOG"));
+    }
+
     void testRibbon()
     {
         RcFile rcFile = parse(Test::testDataPath() + "/rcfiles/ribbon/RibbonApplication.rc");
@@ -187,6 +419,13 @@ private slots:
         QCOMPARE(context.id, "ID_CONTEXT2");
         QCOMPARE(context.text, "Context1");
         QCOMPARE(context.categories.size(), 1);
+
+        QCOMPARE(ribbon->elementFromId("ID_FILE_NEW").text, "&New");
+        QCOMPARE(ribbon->elementFromId("ID_EDIT_FIND"), findButton);
+        QCOMPARE(ribbon->elementFromId("ID_EDIT_FIND").text, findButton.text);
+        // Only the elements of the menu and of the categories are searched, not the sub-elements
+        QVERIFY(ribbon->elementFromId("ID_FILE_PRINT_PREVIEW").id.isEmpty());
+        QVERIFY(ribbon->elementFromId("ID_DOES_NOT_EXIST").id.isEmpty());
     }
 };
 
@@ -12,8 +12,15 @@
 #include "rccore/rcfile.h"
 
 #include <QBuffer>
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QSet>
+#include <QTemporaryDir>
 #include <QTest>
 #include <QUiLoader>
 
@@ -60,6 +67,61 @@ private slots:
         }
     }
 
+    void testWriteAssetsToImage()
+    {
+        RcFile rcFile = parse(Test::testDataPath() + "/rcfiles/mainWindow/MainWindow.rc");
+        auto data = rcFile.data.value("LANG_ENGLISH;SUBLANG_ENGLISH_US");
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+
+        auto assets = convertAssets(data);
+        QCOMPARE(assets.size(), 8);
+        for (auto &asset : assets)
+            asset.fileName = dir.filePath(QFileInfo(asset.fileName).fileName());
+        QVERIFY(writeAssetsToImage(assets));
+
+        for (const auto &asset : std::as_const(assets)) {
+            const QImage image(asset.fileName);
+            QVERIFY2(!image.isNull(), qPrintable(asset.fileName));
+            QCOMPARE(image.size(), asset.iconRect.size());
+            QVERIFY(image.hasAlphaChannel());
+        }
+    }
+
+    void testWriteAssetsToAtlas()
+    {
+        RcFile rcFile = parse(Test::testDataPath() + "/rcfiles/mainWindow/MainWindow.rc");
+        auto data = rcFile.data.value("LANG_ENGLISH;SUBLANG_ENGLISH_US");
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+
+        const auto assets = convertAssets(data);
+        const QString fileName = dir.filePath("atlas.png");
+        QVERIFY(writeAssetsToAtlas(assets, fileName));
+
+        const QImage atlas(fileName);
+        QVERIFY(!atlas.isNull());
+        QVERIFY(atlas.hasAlphaChannel());
+
+        QFile file(dir.filePath("atlas.json"));
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+        QCOMPARE(root.value("image").toString(), "atlas.png");
+        const QJsonArray icons = root.value("icons").toArray();
+        QCOMPARE(icons.size(), assets.size());
+        for (int i = 0; i < icons.size(); ++i) {
+            const QJsonObject icon = icons.at(i).toObject();
+            QCOMPARE(icon.value("id").toString(), assets.at(i).id);
+            const QRect rect(icon.value("x").toInt(), icon.value("y").toInt(), icon.value("width").toInt(),
+                             icon.value("height").toInt());
+            QVERIFY(atlas.rect().contains(rect));
+            if (!assets.at(i).iconRect.isNull())
+                QCOMPARE(rect.size(), assets.at(i).iconRect.size());
+        }
+    }
+
     void testConvertDialog()
     {
         RcFile rcFile = parse(Test::testDataPath() + "/rcfiles/luaDebugger/LuaDebugger.rc");
@@ -122,6 +184,27 @@ private slots:
         }
     }
 
+    void testWriteDialogs()
+    {
+        RcFile rcFile = parse(Test::testDataPath() + "/rcfiles/cryEdit/CryEdit.rc");
+        auto data = rcFile.data.value("LANG_ENGLISH;SUBLANG_ENGLISH_US");
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QVERIFY(writeDialogsToUi(data, {}, dir.path(), RcCore::Widget::AllFlags));
+        QCOMPARE(QDir(dir.path()).entryList({"*.ui"}).size(), data.dialogs.size());
+
+        // Same result as writing each dialog one by one
+        const QString id = "IDD_LIGHTING";
+        QFile file(dir.filePath(id + ".ui"));
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QFile expected(Test::testDataPath() + QStringLiteral("/tst_rcwriter/%1.ui").arg(id));
+        QVERIFY(expected.open(QIODevice::ReadOnly));
+        QCOMPARE(file.readAll(), expected.readAll());
+
+        QVERIFY(!writeDialogsToUi(data, {"IDD_DOES_NOT_EXIST"}, dir.path()));
+    }
+
     void testConvertAction()
     {
         RcFile rcFile = parse(Test::testDataPath() + "/rcfiles/cryEdit/CryEdit.rc");
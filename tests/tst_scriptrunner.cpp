@@ -0,0 +1,193 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "common/test_utils.h"
+#include "core/knutcore.h"
+#include "core/scriptmanager.h"
+#include "core/scriptrunner.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QQmlEngine>
+#include <QTemporaryDir>
+#include <QTest>
+
+static void writeFile(const QString &fileName, const QByteArray &data)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(data);
+}
+
+class TestScriptRunner : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() { Q_INIT_RESOURCE(core); }
+
+    void reuseEngine()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString fileName = dir.filePath("script.js");
+        writeFile(fileName, "function main() { return 1; }\n");
+
+        Core::KnutCore core;
+        Core::ScriptRunner runner;
+        // Let the runner pre-warm its engine, so the number of engines doesn't depend on when it's done
+        QCoreApplication::processEvents();
+        const auto engineCount = runner.findChildren<QQmlEngine *>().size();
+        int finished = 0;
+        auto endCallback = [&finished]() {
+            ++finished;
+        };
+
+        QCOMPARE(runner.runScript(fileName, nlohmann::json::object(), endCallback).toInt(), 1);
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        QCOMPARE(finished, 1);
+        QCOMPARE(runner.runScript(fileName, nlohmann::json::object(), endCallback).toInt(), 1);
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        QCOMPARE(finished, 2);
+        QCOMPARE(runner.findChildren<QQmlEngine *>().size(), engineCount);
+
+        // A change in the script invalidates the compiled script
+        writeFile(fileName, "function main() { return 2; }\n");
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(10), QFileDevice::FileModificationTime));
+        file.close();
+        QCOMPARE(runner.runScript(fileName, nlohmann::json::object(), endCallback).toInt(), 2);
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        QCOMPARE(finished, 3);
+        QVERIFY(!runner.hasError());
+    }
+
+    void libraryState()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        writeFile(dir.filePath("library.js"),
+                  ".pragma library\nvar count = 0;\nfunction increment() { return ++count; }\n");
+        const QString fileName = dir.filePath("script.js");
+        writeFile(fileName, ".import \"library.js\" as Library\nfunction main() { return Library.increment(); }\n");
+
+        Core::KnutCore core;
+        Core::ScriptRunner runner;
+        // The library state is not shared between runs
+        QCOMPARE(runner.runScript(fileName, nlohmann::json::object()).toInt(), 1);
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        QCOMPARE(runner.runScript(fileName, nlohmann::json::object()).toInt(), 1);
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        QVERIFY(!runner.hasError());
+    }
+
+    void compileScript()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        writeFile(dir.filePath("valid.js"), "function main() { return 1; }\n");
+        writeFile(dir.filePath("valid.qml"), "import Knut\n\nScript {\n    function run() {}\n}\n");
+        writeFile(dir.filePath("invalid.qml"), "import Knut\n\nScript {\n    function run( {}\n}\n");
+
+        Core::KnutCore core;
+        Core::ScriptRunner runner;
+        QVERIFY(runner.compileScript(dir.filePath("valid.js")));
+        QVERIFY(runner.compileScript(dir.filePath("valid.qml")));
+        QVERIFY(!runner.compileScript(dir.filePath("invalid.qml")));
+    }
+
+    void jobQueue()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        writeFile(dir.filePath("low.js"), "function main() { return 1; }\n");
+        writeFile(dir.filePath("high.js"), "function main() { return 2; }\n");
+
+        Core::KnutCore core;
+        auto manager = Core::ScriptManager::instance();
+
+        QStringList started;
+        connect(manager, &Core::ScriptManager::jobStarted, this, [&started](Core::ScriptJob *job) {
+            started.push_back(QFileInfo(job->fileName()).baseName());
+        });
+        QMap<QString, std::pair<Core::ScriptJob::Status, QVariant>> finished;
+        connect(manager, &Core::ScriptManager::jobFinished, this, [&finished](Core::ScriptJob *job) {
+            finished[QFileInfo(job->fileName()).baseName()] = {job->status(), job->result()};
+        });
+
+        manager->runScriptAsync(dir.filePath("low.js"), nlohmann::json::object(), Core::ScriptJob::Low, false);
+        manager->runScriptAsync(dir.filePath("high.js"), nlohmann::json::object(), Core::ScriptJob::High, false);
+        auto cancelled = manager->runScriptAsync(dir.filePath("cancelled.js"), nlohmann::json::object(),
+                                                 Core::ScriptJob::Normal, false);
+        manager->runScriptAsync(dir.filePath("missing.js"), nlohmann::json::object(), Core::ScriptJob::Normal, false);
+        QCOMPARE(manager->jobs().size(), 4);
+
+        // Pending jobs can be cancelled
+        QVERIFY(cancelled->cancel());
+        QCOMPARE(finished.value("cancelled").first, Core::ScriptJob::Cancelled);
+        QCOMPARE(manager->jobs().size(), 3);
+        QVERIFY(started.isEmpty());
+
+        QTRY_COMPARE(finished.size(), 4);
+        QCOMPARE(started, QStringList({"high", "missing", "low"}));
+        QCOMPARE(finished.value("high").first, Core::ScriptJob::Finished);
+        QCOMPARE(finished.value("high").second.toInt(), 2);
+        QCOMPARE(finished.value("low").first, Core::ScriptJob::Finished);
+        QCOMPARE(finished.value("low").second.toInt(), 1);
+        QCOMPARE(finished.value("missing").first, Core::ScriptJob::Failed);
+        QVERIFY(manager->jobs().isEmpty());
+    }
+
+    void scriptCatalog()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = QFileInfo(dir.path()).absoluteFilePath();
+        writeFile(dir.filePath("first.js"), "// First script\nfunction main() {}\n");
+        writeFile(dir.filePath("second.qml"), "// Second script\nimport Knut\n\nScript {}\n");
+
+        Core::KnutCore core;
+        auto manager = Core::ScriptManager::instance();
+        // Returns a null string if the script doesn't exist
+        auto description = [manager](const QString &name) -> QString {
+            for (const auto &script : manager->scriptList()) {
+                if (script.name == name)
+                    return script.description;
+            }
+            return QString();
+        };
+
+        // Scripts are added once the directory has been scanned
+        manager->addDirectory(path);
+        manager->waitForScripts();
+        QCOMPARE(description("first.js"), QString("First script"));
+        QCOMPARE(description("second.qml"), QString("Second script"));
+        // The finished signal of the scan is still delivered, the scan is not applied twice
+        const auto scriptCount = manager->scriptList().size();
+        QCoreApplication::processEvents();
+        QCOMPARE(manager->scriptList().size(), scriptCount);
+
+        // Changed and deleted scripts are updated when the directory changes
+        writeFile(dir.filePath("first.js"), "// First script, changed\nfunction main() {}\n");
+        QVERIFY(QFile::remove(dir.filePath("second.qml")));
+        QTRY_VERIFY(description("second.qml").isNull());
+        manager->waitForScripts();
+        QCOMPARE(description("first.js"), QString("First script, changed"));
+
+        manager->removeDirectory(path);
+        QVERIFY(description("first.js").isNull());
+    }
+};
+
+QTEST_MAIN(TestScriptRunner)
+#include "tst_scriptrunner.moc"
@@ -15,8 +15,10 @@
 #include "core/textdocument.h"
 #include "core/utils.h"
 
+#include <QCoreApplication>
 #include <QDir>
 #include <QFile>
+#include <QPlainTextEdit>
 #include <QTest>
 #include <QTextStream>
 
@@ -240,6 +242,50 @@ private slots:
         }
     }
 
+    void undoMemoryLimit()
+    {
+        Core::TextDocument document;
+        document.load(Test::testDataPath() + "/tst_textdocument/loremipsum_lf_utf8.txt");
+        QCOMPARE(document.undoMemoryUsage(), 0);
+
+        // Editions are compacted into a snapshot once the limit is reached
+        document.setUndoMemoryLimit(4096);
+        for (int i = 0; i < 50; ++i) {
+            document.gotoLine(2);
+            document.insert("Hello World! ");
+            // The compaction is done once the edit is finished
+            QCoreApplication::processEvents();
+        }
+        QVERIFY(document.text() != LoremIpsumText);
+        QVERIFY(document.undoMemoryUsage() <= 4096);
+        const int undoSteps = document.textEdit()->document()->availableUndoSteps();
+        QVERIFY(undoSteps < 50);
+        document.undo(undoSteps);
+        QVERIFY(document.text() != LoremIpsumText);
+        document.undo();
+        QCOMPARE(document.text(), LoremIpsumText);
+        QCOMPARE(document.undoMemoryUsage(), 0);
+
+        // Snapshots larger than the limit are dropped
+        document.setUndoMemoryLimit(1024);
+        for (int i = 0; i < 50; ++i) {
+            document.gotoLine(2);
+            document.insert("Hello World! ");
+            QCoreApplication::processEvents();
+        }
+        QVERIFY(document.undoMemoryUsage() <= 1024);
+        document.undo(50);
+        QVERIFY(document.text() != LoremIpsumText);
+
+        // No undo history at all
+        document.setUndoMemoryLimit(0);
+        document.gotoLine(2);
+        document.insert("Hello World! ");
+        document.undo();
+        QVERIFY(document.text() != LoremIpsumText);
+        QCOMPARE(document.undoMemoryUsage(), 0);
+    }
+
     void mark()
     {
         Core::TextDocument document;
@@ -411,6 +457,31 @@ private slots:
 #undef COMPARE_LINE_INDENT
     }
 
+    void indentRange()
+    {
+        Core::KnutCore core;
+        Core::TextDocument document;
+        document.setText("int a;\n    int b;\nint c;\n");
+        const int undoSteps = document.textEdit()->document()->availableUndoSteps();
+
+        document.gotoLine(3, 5);
+        auto mark = document.createMark();
+
+        document.gotoLine(1);
+        document.selectNextLine(2);
+        document.setIndentation(1);
+        QCOMPARE(document.text(), "    int a;\n    int b;\n    int c;\n");
+
+        // Only the indentation is changed, so marks inside the lines are kept
+        QCOMPARE(mark.line(), 3);
+        QCOMPARE(mark.column(), 9);
+
+        // All lines are indented in one edit
+        QCOMPARE(document.textEdit()->document()->availableUndoSteps(), undoSteps + 1);
+        document.undo();
+        QCOMPARE(document.text(), "int a;\n    int b;\nint c;\n");
+    }
+
     void findReplace()
     {
         Test::FileTester file(Test::testDataPath() + "/tst_textdocument/findReplace/findreplace.txt");
@@ -178,6 +178,46 @@ private slots:
         QCOMPARE(matches[6].captures().size(), 2);
     }
 
+    void progressCallback()
+    {
+        auto source = readTestFile("/tst_treesitter/main.cpp");
+
+        treesitter::Parser parser(tree_sitter_cpp());
+        auto tree = parser.parseString(source);
+
+        auto query = std::make_shared<treesitter::Query>(tree_sitter_cpp(), R"EOF(
+                (parameter_list
+                    ["," (parameter_declaration) @arg]+)
+        )EOF");
+
+        // The callback is called for each match, with increasing positions
+        QList<std::pair<uint32_t, uint32_t>> progress;
+        treesitter::QueryCursor cursor;
+        cursor.setProgressCallback([&](uint32_t position, uint32_t size) {
+            progress.push_back({position, size});
+            return true;
+        });
+        cursor.execute(query, tree->rootNode(), std::make_unique<treesitter::Predicates>(source));
+        QCOMPARE(cursor.allRemainingMatches().size(), 7);
+        QCOMPARE(progress.size(), 7);
+        uint32_t lastPosition = 0;
+        for (const auto &[position, size] : std::as_const(progress)) {
+            QVERIFY(position >= lastPosition);
+            QVERIFY(position <= size);
+            lastPosition = position;
+        }
+
+        // Cancel the query after 2 matches
+        treesitter::QueryCursor cancelledCursor;
+        int callCount = 0;
+        cancelledCursor.setProgressCallback([&](uint32_t, uint32_t) {
+            return ++callCount <= 2;
+        });
+        cancelledCursor.execute(query, tree->rootNode(), std::make_unique<treesitter::Predicates>(source));
+        QCOMPARE(cancelledCursor.allRemainingMatches().size(), 2);
+        QVERIFY(!cancelledCursor.nextMatch().has_value());
+    }
+
     void eq_predicate_errors()
     {
         using Error = treesitter::Query::Error;
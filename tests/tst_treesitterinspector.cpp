@@ -0,0 +1,66 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "common/test_utils.h"
+#include "core/codedocument.h"
+#include "core/knutcore.h"
+#include "core/project.h"
+#include "gui/treesitterinspector.h"
+
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTreeView>
+
+class TestTreeSitterInspector : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase()
+    {
+        Q_INIT_RESOURCE(core);
+        Q_INIT_RESOURCE(gui);
+    }
+
+    void dropOutdatedParse()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString fileName = dir.filePath("main.cpp");
+        QVERIFY(QFile::copy(Test::testDataPath() + "/projects/cpp-project/main.cpp", fileName));
+
+        Core::KnutCore core;
+        auto project = Core::Project::instance();
+        project->setRoot(dir.path());
+        auto document = qobject_cast<Core::CodeDocument *>(project->open(fileName));
+        QVERIFY(document);
+
+        // The inspector starts parsing the document as soon as it's created
+        Gui::TreeSitterInspector inspector;
+        auto treeView = inspector.findChild<QTreeView *>("treeInspector");
+        QVERIFY(treeView);
+        QSignalSpy resetSpy(treeView->model(), &QAbstractItemModel::modelReset);
+
+        // The text is changed before the first parse is done: its result is dropped, and only the new text is shown
+        document->setText("int changed;\n");
+        QTRY_COMPARE(resetSpy.count(), 1);
+        QTest::qWait(1000);
+        QCOMPARE(resetSpy.count(), 1);
+
+        auto model = treeView->model();
+        QCOMPARE(model->rowCount(), 1);
+        QCOMPARE(model->rowCount(model->index(0, 0)), 1);
+    }
+};
+
+QTEST_MAIN(TestTreeSitterInspector)
+#include "tst_treesitterinspector.moc"
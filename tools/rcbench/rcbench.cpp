@@ -0,0 +1,289 @@
+/*
+  This file is part of Knut.
+
+  SPDX-FileCopyrightText: 2024 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+// Benchmark of the RC pipeline: lexing, parsing and conversion of a synthetic RC file.
+// The RC file is generated with a configurable number of dialogs, menus, accelerator tables and strings, and the
+// results are written as json, so they can be compared between runs.
+
+#include "rccore/lexer.h"
+#include "rccore/rcfile.h"
+#include "rccore/stream.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <spdlog/spdlog.h>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+// Needs to be included after windows.h
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+struct Scale
+{
+    int languages = 1;
+    int dialogs = 0;
+    int menus = 0;
+    int accelerators = 0;
+    int strings = 0;
+};
+
+static QString generateRcFile(const Scale &scale)
+{
+    static constexpr const char *Languages[][2] = {
+        {"LANG_ENGLISH", "SUBLANG_ENGLISH_US"}, {"LANG_FRENCH", "SUBLANG_FRENCH"},
+        {"LANG_GERMAN", "SUBLANG_GERMAN"},      {"LANG_SPANISH", "SUBLANG_SPANISH"},
+        {"LANG_ITALIAN", "SUBLANG_ITALIAN"},    {"LANG_DUTCH", "SUBLANG_DUTCH"},
+    };
+
+    QString content;
+    QTextStream out(&content);
+    out << "// Generated by rcbench\n\n";
+
+    for (int language = 0; language < scale.languages; ++language) {
+        const auto &names = Languages[language % std::size(Languages)];
+        out << "LANGUAGE " << names[0] << ", " << names[1] << "\n\n";
+
+        for (int i = 0; i < scale.dialogs; ++i) {
+            out << "IDD_DIALOG_" << i << " DIALOGEX 0, 0, 320, 200\n"
+                << "STYLE DS_SETFONT | DS_MODALFRAME | DS_FIXEDSYS | WS_POPUP | WS_CAPTION | WS_SYSMENU\n"
+                << "CAPTION \"Dialog " << i << "\"\n"
+                << "FONT 8, \"MS Shell Dlg\", 400, 0, 0x1\n"
+                << "BEGIN\n"
+                << "    DEFPUSHBUTTON   \"OK\",IDOK,209,179,50,14\n"
+                << "    PUSHBUTTON      \"Cancel\",IDCANCEL,263,179,50,14\n"
+                << "    LTEXT           \"Label " << i << ":\",IDC_STATIC,7,7,100,8\n"
+                << "    EDITTEXT        IDC_EDIT_" << i << ",7,20,150,14,ES_AUTOHSCROLL\n"
+                << "    CONTROL         \"Check\",IDC_CHECK_" << i
+                << ",\"Button\",BS_AUTOCHECKBOX | WS_TABSTOP,7,40,60,10\n"
+                << "    COMBOBOX        IDC_COMBO_" << i
+                << ",7,56,100,30,CBS_DROPDOWNLIST | CBS_SORT | WS_VSCROLL | WS_TABSTOP\n"
+                << "    GROUPBOX        \"Group\",IDC_STATIC,7,80,150,60\n"
+                << "    CONTROL         \"Radio\",IDC_RADIO_" << i
+                << ",\"Button\",BS_AUTORADIOBUTTON | WS_GROUP,14,94,60,10\n"
+                << "END\n\n";
+        }
+
+        for (int i = 0; i < scale.menus; ++i) {
+            out << "IDR_MENU_" << i << " MENU\n"
+                << "BEGIN\n"
+                << "    POPUP \"&File\"\n"
+                << "    BEGIN\n"
+                << "        MENUITEM \"&New\\tCtrl+N\",                ID_FILE_NEW_" << i << "\n"
+                << "        MENUITEM \"&Open...\\tCtrl+O\",            ID_FILE_OPEN_" << i << "\n"
+                << "        MENUITEM SEPARATOR\n"
+                << "        MENUITEM \"E&xit\",                       ID_APP_EXIT_" << i << "\n"
+                << "    END\n"
+                << "    POPUP \"&Edit\"\n"
+                << "    BEGIN\n"
+                << "        MENUITEM \"&Undo\\tCtrl+Z\",               ID_EDIT_UNDO_" << i << "\n"
+                << "        MENUITEM \"&Copy\\tCtrl+C\",               ID_EDIT_COPY_" << i << "\n"
+                << "    END\n"
+                << "END\n\n";
+        }
+
+        for (int i = 0; i < scale.accelerators; ++i) {
+            out << "IDR_ACCELERATORS_" << i << " ACCELERATORS\n"
+                << "BEGIN\n"
+                << "    \"N\",            ID_FILE_NEW_" << i << ",            VIRTKEY, CONTROL, NOINVERT\n"
+                << "    \"O\",            ID_FILE_OPEN_" << i << ",           VIRTKEY, CONTROL, NOINVERT\n"
+                << "    \"Z\",            ID_EDIT_UNDO_" << i << ",           VIRTKEY, CONTROL, NOINVERT\n"
+                << "    VK_F5,          ID_REFRESH_" << i << ",             VIRTKEY, NOINVERT\n"
+                << "END\n\n";
+        }
+
+        if (scale.strings > 0) {
+            out << "STRINGTABLE\nBEGIN\n";
+            for (int i = 0; i < scale.strings; ++i)
+                out << "    IDS_STRING_" << i << "          \"String number " << i << "\\nTooltip " << i << "\"\n";
+            out << "END\n\n";
+        }
+    }
+    out.flush();
+    return content;
+}
+
+// Peak resident memory of the process, in bytes
+static qint64 peakMemory()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return static_cast<qint64>(counters.PeakWorkingSetSize);
+    return -1;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#if defined(Q_OS_MACOS)
+    return static_cast<qint64>(usage.ru_maxrss);
+#else
+    return static_cast<qint64>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+// Run `function` `iterations` times, and returns the best time in seconds
+template <typename Function>
+static double measure(int iterations, Function function)
+{
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < iterations; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        function();
+        best = std::min(best, static_cast<double>(timer.nsecsElapsed()) / 1e9);
+    }
+    return best;
+}
+
+static double rate(double count, double seconds)
+{
+    return seconds > 0 ? count / seconds : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("rcbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmark of the RC file lexing, parsing and conversion");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"scale", "Default number of each resource.", "count", "1000"},
+        {"languages", "Number of languages.", "count", "1"},
+        {"language", "Language used for the conversions.", "language", "LANG_ENGLISH;SUBLANG_ENGLISH_US"},
+        {"dialogs", "Number of dialogs per language.", "count"},
+        {"menus", "Number of menus per language.", "count"},
+        {"accelerators", "Number of accelerator tables per language.", "count"},
+        {"strings", "Number of strings per language.", "count"},
+        {"iterations", "Number of iterations, the best time is kept.", "count", "3"},
+        {"output", "Write the json results in <file> instead of the standard output.", "file"},
+    });
+    parser.process(app);
+
+    auto intValue = [&parser](const QString &name, int defaultValue) {
+        return parser.isSet(name) ? parser.value(name).toInt() : defaultValue;
+    };
+    const int defaultScale = intValue("scale", 1000);
+    Scale scale;
+    scale.languages = std::max(intValue("languages", 1), 1);
+    scale.dialogs = intValue("dialogs", defaultScale);
+    scale.menus = intValue("menus", defaultScale);
+    scale.accelerators = intValue("accelerators", defaultScale);
+    scale.strings = intValue("strings", defaultScale * 10);
+    const int iterations = std::max(intValue("iterations", 3), 1);
+
+    // Parsing issues are not what is measured here
+    spdlog::set_level(spdlog::level::err);
+
+    const QString content = generateRcFile(scale);
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        spdlog::error("rcbench: can't create a temporary directory");
+        return 1;
+    }
+    const QString fileName = dir.filePath("rcbench.rc");
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(content.toUtf8()) == -1) {
+        spdlog::error("rcbench: can't write {}", fileName.toStdString());
+        return 1;
+    }
+    file.close();
+    const double megaBytes = static_cast<double>(file.size()) / (1024 * 1024);
+
+    // Lexer
+    qint64 tokenCount = 0;
+    const double lexerTime = measure(iterations, [&]() {
+        RcCore::Lexer lexer {RcCore::Stream(content)};
+        tokenCount = 0;
+        while (lexer.next())
+            ++tokenCount;
+    });
+
+    // Parser
+    RcCore::RcFile rcFile;
+    const double parseTime = measure(iterations, [&]() {
+        rcFile = RcCore::parse(fileName);
+    });
+    if (!rcFile.isValid || rcFile.data.isEmpty()) {
+        spdlog::error("rcbench: can't parse {}", fileName.toStdString());
+        return 1;
+    }
+    const QString language = parser.value("language");
+    if (!rcFile.data.contains(language)) {
+        spdlog::error("rcbench: no language {} in {}", language.toStdString(), fileName.toStdString());
+        return 1;
+    }
+    const RcCore::Data data = rcFile.data.value(language);
+
+    // Conversions
+    const double dialogTime = measure(iterations, [&]() {
+        for (const auto &dialog : data.dialogs)
+            RcCore::convertDialog(data, dialog, RcCore::Widget::AllFlags);
+    });
+    qint64 actionCount = 0;
+    const double actionTime = measure(iterations, [&]() {
+        actionCount = RcCore::convertActions(data, RcCore::Asset::NoFlags).size();
+    });
+
+    const QJsonObject results {
+        {"input",
+         QJsonObject {{"bytes", file.size()},
+                      {"lines", static_cast<qint64>(content.count('\n'))},
+                      {"languages", scale.languages},
+                      {"language", language},
+                      {"dialogs", scale.dialogs},
+                      {"menus", scale.menus},
+                      {"accelerators", scale.accelerators},
+                      {"strings", scale.strings},
+                      {"iterations", iterations}}},
+        {"lexer",
+         QJsonObject {{"seconds", lexerTime},
+                      {"tokens", tokenCount},
+                      {"tokensPerSecond", rate(tokenCount, lexerTime)},
+                      {"megaBytesPerSecond", rate(megaBytes, lexerTime)}}},
+        {"parse", QJsonObject {{"seconds", parseTime}, {"megaBytesPerSecond", rate(megaBytes, parseTime)}}},
+        {"convertDialog",
+         QJsonObject {{"seconds", dialogTime},
+                      {"dialogs", static_cast<qint64>(data.dialogs.size())},
+                      {"dialogsPerSecond", rate(data.dialogs.size(), dialogTime)}}},
+        {"convertActions",
+         QJsonObject {{"seconds", actionTime},
+                      {"actions", actionCount},
+                      {"actionsPerSecond", rate(actionCount, actionTime)}}},
+        {"peakMemoryBytes", peakMemory()},
+    };
+    const QByteArray json = QJsonDocument(results).toJson();
+
+    if (parser.isSet("output")) {
+        QFile output(parser.value("output"));
+        if (!output.open(QIODevice::WriteOnly)) {
+            spdlog::error("rcbench: can't write {}", parser.value("output").toStdString());
+            return 1;
+        }
+        output.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+    return 0;
+}